@@ -87,8 +87,6 @@ void IPTrafSink::processPacket(cPacket *msg)
 
 Define_Module(IPTrafGen);
 
-int IPTrafGen::counter;
-
 void IPTrafGen::initialize(int stage)
 {
     // because of IPAddressResolver, we need to wait until interfaces are registered,
@@ -55,7 +55,7 @@ class INET_API IPTrafGen : public IPTrafSink
     int numPackets;
     std::vector<IPvXAddress> destAddresses;
 
-    static int counter; // counter for generating a global number for each packet
+    int counter; // counter for numbering the packets; per module, so names don't depend on partitioning
 
     int numSent;
 
@@ -30,6 +30,8 @@ void TCPSinkApp::initialize()
     TCPSocket socket;
     socket.setOutputGate(gate("tcpOut"));
     socket.bind(address[0] ? IPvXAddress(address) : IPvXAddress(), port);
+    if (par("directDataPath").boolValue() && !socket.setDirectCallback(this))
+        EV << "TCP does not support the direct data path, using messages\n";
     socket.listen();
 }
 
@@ -43,15 +45,7 @@ void TCPSinkApp::handleMessage(cMessage *msg)
     }
     else if (msg->getKind()==TCP_I_DATA || msg->getKind()==TCP_I_URGENT_DATA)
     {
-        bytesRcvd += PK(msg)->getByteLength();
-        delete msg;
-
-        if (ev.isGUI())
-        {
-            char buf[32];
-            sprintf(buf, "rcvd: %ld bytes", bytesRcvd);
-            getDisplayString().setTagArg("t",0,buf);
-        }
+        dataArrived(PK(msg));
     }
     else
     {
@@ -60,6 +54,30 @@ void TCPSinkApp::handleMessage(cMessage *msg)
     }
 }
 
+void TCPSinkApp::dataArrived(cPacket *msg)
+{
+    bytesRcvd += msg->getByteLength();
+    delete msg;
+
+    if (ev.isGUI())
+    {
+        char buf[32];
+        sprintf(buf, "rcvd: %ld bytes", bytesRcvd);
+        getDisplayString().setTagArg("t",0,buf);
+    }
+}
+
+void TCPSinkApp::tcpDataArrived(int connId, cPacket *msg, bool urgent)
+{
+    dataArrived(msg);
+}
+
+void TCPSinkApp::tcpIndicationArrived(cMessage *msg)
+{
+    // same as if it arrived as a message (PEER_CLOSED gets answered with CLOSE)
+    handleMessage(msg);
+}
+
 void TCPSinkApp::finish()
 {
     recordScalar("bytesRcvd", bytesRcvd);
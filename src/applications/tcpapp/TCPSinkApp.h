@@ -16,14 +16,15 @@
 
 #include <omnetpp.h>
 #include "INETDefs.h"
+#include "ITCPDirect.h"
 
 
 
 /**
  * Accepts any number of incoming connections, and discards whatever arrives
- * on them.
+ * on them. Optionally uses the direct data path of TCP (see ITCPDirect).
  */
-class INET_API TCPSinkApp : public cSimpleModule
+class INET_API TCPSinkApp : public cSimpleModule, public ITCPDirectCallback
 {
   protected:
     long bytesRcvd;
@@ -32,6 +33,13 @@ class INET_API TCPSinkApp : public cSimpleModule
     virtual void initialize();
     virtual void handleMessage(cMessage *msg);
     virtual void finish();
+    virtual void dataArrived(cPacket *msg);
+
+    /** @name ITCPDirectCallback methods */
+    //@{
+    virtual void tcpDataArrived(int connId, cPacket *msg, bool urgent);
+    virtual void tcpIndicationArrived(cMessage *msg);
+    //@}
 };
 
 #endif
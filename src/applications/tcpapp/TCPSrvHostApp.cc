@@ -18,10 +18,33 @@
 Define_Module(TCPSrvHostApp);
 
 
+TCPSrvHostApp::TCPSrvHostApp()
+{
+    timerEvent = NULL;
+}
+
+TCPSrvHostApp::~TCPSrvHostApp()
+{
+    cancelAndDelete(timerEvent);
+    for (unsigned int i=0; i<threadPool.size(); i++)
+        delete threadPool[i];
+    for (unsigned int i=0; i<socketPool.size(); i++)
+        delete socketPool[i];
+    socketMap.deleteSockets();
+}
+
 void TCPSrvHostApp::initialize()
 {
     const char *address = par("address");
     int port = par("port");
+    reuseThreads = par("reuseThreads");
+    maxPoolSize = par("maxPoolSize");
+
+    timerEvent = new cMessage("threadTimers");
+
+    numConnections = numThreadsCreated = 0;
+    WATCH(numConnections);
+    WATCH(numThreadsCreated);
 
     serverSocket.setOutputGate(gate("tcpOut"));
     serverSocket.bind(address[0] ? IPvXAddress(address) : IPvXAddress(), port);
@@ -39,8 +62,13 @@ void TCPSrvHostApp::updateDisplay()
 
 void TCPSrvHostApp::handleMessage(cMessage *msg)
 {
-    if (msg->isSelfMessage())
+    if (msg==timerEvent)
     {
+        processThreadTimers();
+    }
+    else if (msg->isSelfMessage())
+    {
+        // timer scheduled directly on this module by a thread
         TCPServerThreadBase *thread = (TCPServerThreadBase *)msg->getContextPointer();
         thread->timerExpired(msg);
     }
@@ -49,12 +77,32 @@ void TCPSrvHostApp::handleMessage(cMessage *msg)
         TCPSocket *socket = socketMap.findSocketFor(msg);
         if (!socket)
         {
-            // new connection -- create new socket object and server process
-            socket = new TCPSocket(msg);
+            // new connection -- create (or recycle) socket object and server process
+            if (socketPool.empty())
+            {
+                socket = new TCPSocket(msg);
+            }
+            else
+            {
+                socket = socketPool.back();
+                socketPool.pop_back();
+                *socket = TCPSocket(msg);
+            }
             socket->setOutputGate(gate("tcpOut"));
 
-            const char *serverThreadClass = par("serverThreadClass");
-            TCPServerThreadBase *proc = check_and_cast<TCPServerThreadBase *>(createOne(serverThreadClass));
+            TCPServerThreadBase *proc;
+            if (!threadPool.empty())
+            {
+                proc = threadPool.back();
+                threadPool.pop_back();
+            }
+            else
+            {
+                const char *serverThreadClass = par("serverThreadClass");
+                proc = check_and_cast<TCPServerThreadBase *>(createOne(serverThreadClass));
+                numThreadsCreated++;
+            }
+            numConnections++;
 
             socket->setCallbackObject(proc);
             proc->init(this, socket);
@@ -69,17 +117,114 @@ void TCPSrvHostApp::handleMessage(cMessage *msg)
 
 void TCPSrvHostApp::finish()
 {
+    recordScalar("connections", numConnections);
+    recordScalar("threads created", numThreadsCreated);
 }
 
 void TCPSrvHostApp::removeThread(TCPServerThreadBase *thread)
 {
-    // remove socket
-    socketMap.removeSocket(thread->getSocket());
+    cancelThreadTimers(thread);
+
+    // remove socket; note that this may be called from within the socket's
+    // processMessage(), which does not touch the socket after the callback
+    TCPSocket *socket = thread->getSocket();
+    socketMap.removeSocket(socket);
+    if (socketPool.size() < maxPoolSize)
+        socketPool.push_back(socket);
+    else
+        delete socket;
 
     // remove thread object
-    delete thread;
+    if (reuseThreads && threadPool.size() < maxPoolSize)
+        threadPool.push_back(thread);
+    else
+        delete thread;
 
     updateDisplay();
 }
 
+void TCPSrvHostApp::scheduleThreadTimer(TCPServerThreadBase *thread, simtime_t t, cMessage *msg)
+{
+    if (t < simTime())
+        error("scheduleAt(): event \"%s\" to be scheduled in the past", msg->getName());
+    if (findThreadTimer(msg)!=timerQueue.end())
+        error("scheduleAt(): timer \"%s\" is already scheduled", msg->getName());
+
+    msg->setContextPointer(thread);
+    msg->setTimestamp(t);
+    timerQueue.insert(std::make_pair(t, msg));
+    thread->numPendingTimers++;
+    rescheduleTimerEvent();
+}
+
+void TCPSrvHostApp::cancelThreadTimer(cMessage *msg)
+{
+    TimerQueue::iterator it = findThreadTimer(msg);
+    if (it!=timerQueue.end())
+    {
+        ((TCPServerThreadBase *)msg->getContextPointer())->numPendingTimers--;
+        timerQueue.erase(it);
+        rescheduleTimerEvent();
+    }
+}
+
+void TCPSrvHostApp::cancelThreadTimers(TCPServerThreadBase *thread)
+{
+    if (thread->numPendingTimers==0)
+        return;
+    for (TimerQueue::iterator it = timerQueue.begin(); it!=timerQueue.end(); )
+    {
+        if (it->second->getContextPointer()==thread)
+            timerQueue.erase(it++);
+        else
+            ++it;
+    }
+    thread->numPendingTimers = 0;
+    rescheduleTimerEvent();
+}
+
+TCPSrvHostApp::TimerQueue::iterator TCPSrvHostApp::findThreadTimer(cMessage *msg)
+{
+    // timers are only in the queue under the time stored in their timestamp
+    std::pair<TimerQueue::iterator, TimerQueue::iterator> range = timerQueue.equal_range(msg->getTimestamp());
+    for (TimerQueue::iterator it = range.first; it!=range.second; ++it)
+        if (it->second==msg)
+            return it;
+    return timerQueue.end();
+}
+
+void TCPSrvHostApp::rescheduleTimerEvent()
+{
+    if (timerQueue.empty())
+    {
+        if (timerEvent->isScheduled())
+            cancelEvent(timerEvent);
+    }
+    else
+    {
+        simtime_t first = timerQueue.begin()->first;
+        if (!timerEvent->isScheduled() || timerEvent->getArrivalTime()!=first)
+        {
+            if (timerEvent->isScheduled())
+                cancelEvent(timerEvent);
+            scheduleAt(first, timerEvent);
+        }
+    }
+}
+
+void TCPSrvHostApp::processThreadTimers()
+{
+    // expired timers are removed before invoking the thread, so that it
+    // can reschedule them
+    while (!timerQueue.empty() && timerQueue.begin()->first <= simTime())
+    {
+        cMessage *timer = timerQueue.begin()->second;
+        timerQueue.erase(timerQueue.begin());
+        TCPServerThreadBase *thread = (TCPServerThreadBase *)timer->getContextPointer();
+        thread->numPendingTimers--;
+        thread->timerExpired(timer);
+    }
+    rescheduleTimerEvent();
+}
+
 
@@ -14,6 +14,8 @@
 #ifndef __INET_TCPSRVHOSTAPP_H
 #define __INET_TCPSRVHOSTAPP_H
 
+#include <map>
+#include <vector>
 #include <omnetpp.h>
 #include "TCPSocket.h"
 #include "TCPSocketMap.h"
@@ -23,9 +25,11 @@
 class TCPServerThreadBase;
 
 /**
- * Hosts a server application, to be subclassed from TCPServerProcess (which
- * is a sSimpleModule). Creates one instance (using dynamic module creation)
- * for each incoming connection. More info in the corresponding NED file.
+ * Hosts a server application, to be subclassed from TCPServerThreadBase.
+ * Creates one instance for each incoming connection. Socket objects, and
+ * optionally thread objects, are recycled after the connection closes.
+ * Timers of all threads are multiplexed over a single self-message.
+ * More info in the corresponding NED file.
  */
 class INET_API TCPSrvHostApp : public cSimpleModule
 {
@@ -33,21 +37,54 @@ class INET_API TCPSrvHostApp : public cSimpleModule
     TCPSocket serverSocket;
     TCPSocketMap socketMap;
 
+    // recycled objects
+    bool reuseThreads;
+    unsigned int maxPoolSize;
+    std::vector<TCPServerThreadBase *> threadPool;
+    std::vector<TCPSocket *> socketPool;
+
+    // thread timers, ordered by expiry time; only the first one is
+    // scheduled, as timerEvent
+    typedef std::multimap<simtime_t, cMessage *> TimerQueue;
+    TimerQueue timerQueue;
+    cMessage *timerEvent;
+
+    // statistics
+    long numConnections;
+    long numThreadsCreated;
+
   protected:
     virtual void initialize();
     virtual void handleMessage(cMessage *msg);
     virtual void finish();
 
     virtual void updateDisplay();
+    virtual void processThreadTimers();
+    virtual void rescheduleTimerEvent();
+    virtual TimerQueue::iterator findThreadTimer(cMessage *msg);
 
   public:
+    TCPSrvHostApp();
+    virtual ~TCPSrvHostApp();
+
     virtual void removeThread(TCPServerThreadBase *thread);
+
+    /** @name Timers of server threads; use TCPServerThreadBase::scheduleAt() and cancelEvent() instead */
+    //@{
+    virtual void scheduleThreadTimer(TCPServerThreadBase *thread, simtime_t t, cMessage *msg);
+    virtual void cancelThreadTimer(cMessage *msg);
+    virtual void cancelThreadTimers(TCPServerThreadBase *thread);
+    //@}
 };
 
 /**
  * Abstract base class for server processes to be used with TCPSrvHostApp.
  * Subclasses need to be registered using the Register_Class() macro.
  *
+ * If TCPSrvHostApp's reuseThreads parameter is set, a thread object may
+ * be used for several connections one after another, so subclasses must
+ * (re)initialize their per-connection state in established().
+ *
  * @see TCPSrvHostApp
  */
 class INET_API TCPServerThreadBase : public cPolymorphic, public TCPSocket::CallbackInterface
@@ -56,6 +93,9 @@ class INET_API TCPServerThreadBase : public cPolymorphic, public TCPSocket::Call
     TCPSrvHostApp *hostmod;
     TCPSocket *sock; // ptr into socketMap managed by TCPSrvHostApp
 
+  public:
+    int numPendingTimers; // internal: maintained by TCPSrvHostApp
+
   protected:
     // internal: TCPSocket::CallbackInterface methods
     virtual void socketDataArrived(int, void *, cPacket *msg, bool urgent) {dataArrived(msg,urgent);}
@@ -69,7 +109,7 @@ class INET_API TCPServerThreadBase : public cPolymorphic, public TCPSocket::Call
     virtual void init(TCPSrvHostApp *hostmodule, TCPSocket *socket) {hostmod=hostmodule; sock=socket;}
 
   public:
-    TCPServerThreadBase()  {sock=NULL;}
+    TCPServerThreadBase()  {sock=NULL; numPendingTimers=0;}
     virtual ~TCPServerThreadBase() {}
 
     /** Returns the socket object */
@@ -79,13 +119,15 @@ class INET_API TCPServerThreadBase : public cPolymorphic, public TCPSocket::Call
     virtual TCPSrvHostApp *getHostModule() {return hostmod;}
 
     /**
-     * Schedule an event. Do not use getContextPointer() of cMessage, because
-     * TCPServerThreadBase uses it for its own purposes.
+     * Schedule an event. Do not use getContextPointer() and getTimestamp()
+     * of cMessage, because TCPServerThreadBase uses them for its own purposes.
+     * Timers still pending when the thread is removed are cancelled (but
+     * not deleted).
      */
-    virtual void scheduleAt(simtime_t t, cMessage *msg)  {msg->setContextPointer(this); hostmod->scheduleAt(t,msg);}
+    virtual void scheduleAt(simtime_t t, cMessage *msg)  {hostmod->scheduleThreadTimer(this,t,msg);}
 
     /** Cancel an event */
-    virtual void cancelEvent(cMessage *msg)  {hostmod->cancelEvent(msg);}
+    virtual void cancelEvent(cMessage *msg)  {hostmod->cancelThreadTimer(msg);}
 
     /** @name Callback methods, called on different socket events. */
     //@{
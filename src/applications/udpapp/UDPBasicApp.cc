@@ -25,8 +25,6 @@
 
 Define_Module(UDPBasicApp);
 
-int UDPBasicApp::counter;
-
 void UDPBasicApp::initialize(int stage)
 {
     // because of IPAddressResolver, we need to wait until interfaces are registered,
@@ -35,7 +35,7 @@ class INET_API UDPBasicApp : public UDPAppBase
     int localPort, destPort;
     std::vector<IPvXAddress> destAddresses;
 
-    static int counter; // counter for generating a global number for each packet
+    int counter; // counter for numbering the packets; per module, so names don't depend on partitioning
 
     int numSent;
     int numReceived;
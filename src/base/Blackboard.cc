@@ -62,7 +62,7 @@ void Blackboard::handleMessage(cMessage *msg)
 
 BBItemRef Blackboard::publish(const char *label, cPolymorphic *item)
 {
-    Enter_Method("publish(\"%s\", %s *ptr)", label, item->getClassName());
+    Enter_Method_Lite("publish(\"%s\", %s *ptr)", label, item->getClassName());
 
     // check uniqueness of label
     ContentsMap::iterator k = contents.find(std::string(label));
@@ -87,7 +87,7 @@ BBItemRef Blackboard::publish(const char *label, cPolymorphic *item)
 
 void Blackboard::withdraw(BBItemRef bbItem)
 {
-    Enter_Method("withdraw(\"%s\")", bbItem->getLabel());
+    Enter_Method_Lite("withdraw(\"%s\")", bbItem->getLabel());
 
     // find on BB
     ContentsMap::iterator k = contents.find(bbItem->_label);
@@ -109,7 +109,7 @@ void Blackboard::changed(BBItemRef bbItem, cPolymorphic *item)
 {
   coreEV <<"enter changed; item: "<<bbItem->getLabel()<<" changed -> notify subscribers\n";
 
-  Enter_Method("changed(\"%s\", %s *ptr)", bbItem->getLabel(), item->getClassName());
+  Enter_Method_Lite("changed(\"%s\", %s *ptr)", bbItem->getLabel(), item->getClassName());
 
     // update data pointer
     if (item)
@@ -123,7 +123,7 @@ void Blackboard::changed(BBItemRef bbItem, cPolymorphic *item)
 
 BBItemRef Blackboard::subscribe(BlackboardAccess *bbClient, const char *label)
 {
-    Enter_Method("subscribe(this,\"%s\")", label);
+    Enter_Method_Lite("subscribe(this,\"%s\")", label);
 
     // look up item by label
     BBItemRef item = find(label);
@@ -144,7 +144,7 @@ BBItemRef Blackboard::find(const char *label)
 
 BBItemRef Blackboard::subscribe(BlackboardAccess *bbClient, BBItemRef bbItem)
 {
-    Enter_Method("subscribe(this,\"%s\")", bbItem->getLabel());
+    Enter_Method_Lite("subscribe(this,\"%s\")", bbItem->getLabel());
 
     // check if already subscribed
     SubscriberVector& vec = bbItem->subscribers;
@@ -160,7 +160,7 @@ BBItemRef Blackboard::subscribe(BlackboardAccess *bbClient, BBItemRef bbItem)
 
 void Blackboard::unsubscribe(BlackboardAccess *bbClient, BBItemRef bbItem)
 {
-    Enter_Method("unsubscribe(this,\"%s\")", bbItem->getLabel());
+    Enter_Method_Lite("unsubscribe(this,\"%s\")", bbItem->getLabel());
 
     // check if already subscribed
     SubscriberVector& vec = bbItem->subscribers;
@@ -174,7 +174,7 @@ void Blackboard::unsubscribe(BlackboardAccess *bbClient, BBItemRef bbItem)
 
 void Blackboard::registerClient(BlackboardAccess *bbClient)
 {
-    Enter_Method("registerClient(this)");
+    Enter_Method_Lite("registerClient(this)");
 
     // check if already subscribed
     SubscriberVector& vec = registeredClients;
@@ -187,7 +187,7 @@ void Blackboard::registerClient(BlackboardAccess *bbClient)
 
 void Blackboard::removeClient(BlackboardAccess *bbClient)
 {
-    Enter_Method("removeClient(this)");
+    Enter_Method_Lite("removeClient(this)");
 
     // check if subscribed
     SubscriberVector& vec = registeredClients;
@@ -201,7 +201,7 @@ void Blackboard::removeClient(BlackboardAccess *bbClient)
 
 void Blackboard::getBlackboardContent(BlackboardAccess *bbClient)
 {
-    Enter_Method("getBlackboardContent(this)");
+    Enter_Method_Lite("getBlackboardContent(this)");
 
     for (ContentsMap::iterator i=contents.begin(); i!=contents.end(); ++i)
         bbClient->blackboardItemPublished((*i).second);
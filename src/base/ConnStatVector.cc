@@ -0,0 +1,115 @@
+//
+// Copyright (C) 2009 Andras Varga
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include "ConnStatVector.h"
+
+
+ConnStatVector::ConnStatVector(const char *name, bool recordVector, cStatistic *summary)
+{
+    this->name = name;
+    this->recordVector = recordVector;
+    this->vector = NULL;
+    this->summary = summary;
+}
+
+ConnStatVector::~ConnStatVector()
+{
+    delete vector;
+}
+
+bool ConnStatVector::record(double value)
+{
+    if (summary)
+        summary->collect(value);
+    if (!recordVector)
+        return false;
+    if (!vector)
+        vector = new cOutVector(name.c_str());
+    return vector->record(value);
+}
+
+
+ConnStatRecorder::ConnStatRecorder()
+{
+    enabled = true;
+    vectorSamplingRatio = 1;
+    summaryMode = SUMMARY_NONE;
+    numConnections = 0;
+}
+
+ConnStatRecorder::~ConnStatRecorder()
+{
+    for (SummaryMap::iterator it = summaries.begin(); it != summaries.end(); ++it)
+        delete it->second;
+}
+
+void ConnStatRecorder::configure(bool enabled, int vectorSamplingRatio, const char *summaryMode)
+{
+    if (vectorSamplingRatio < 0)
+        opp_error("ConnStatRecorder: invalid vector sampling ratio %d, must be >= 0", vectorSamplingRatio);
+    this->enabled = enabled;
+    this->vectorSamplingRatio = vectorSamplingRatio;
+
+    if (!strcmp(summaryMode, "none"))
+        this->summaryMode = SUMMARY_NONE;
+    else if (!strcmp(summaryMode, "stddev"))
+        this->summaryMode = SUMMARY_STDDEV;
+    else if (!strcmp(summaryMode, "histogram"))
+        this->summaryMode = SUMMARY_HISTOGRAM;
+    else
+        opp_error("ConnStatRecorder: invalid summary mode '%s', must be one of none, stddev, histogram", summaryMode);
+}
+
+bool ConnStatRecorder::selectConnection()
+{
+    if (!enabled || vectorSamplingRatio == 0)
+        return false;
+    return (numConnections++ % vectorSamplingRatio) == 0;
+}
+
+ConnStatVector *ConnStatRecorder::createVector(const char *name, bool recordVector, const char *summaryName)
+{
+    if (!enabled || (!recordVector && summaryMode == SUMMARY_NONE))
+        return NULL;
+
+    cStatistic *summary = NULL;
+    if (summaryMode != SUMMARY_NONE)
+    {
+        if (!summaryName)
+            summaryName = name;
+        SummaryMap::iterator it = summaries.find(summaryName);
+        if (it != summaries.end())
+            summary = it->second;
+        else
+        {
+            if (summaryMode == SUMMARY_STDDEV)
+                summary = new cStdDev(summaryName);
+            else
+                summary = new cDoubleHistogram(summaryName);
+            summaries[summaryName] = summary;
+        }
+    }
+    return new ConnStatVector(name, recordVector, summary);
+}
+
+void ConnStatRecorder::recordSummaries()
+{
+    for (SummaryMap::iterator it = summaries.begin(); it != summaries.end(); ++it)
+        it->second->recordAs(it->first.c_str());
+}
+
@@ -0,0 +1,106 @@
+//
+// Copyright (C) 2009 Andras Varga
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_CONNSTATVECTOR_H
+#define __INET_CONNSTATVECTOR_H
+
+#include <map>
+#include <string>
+#include <omnetpp.h>
+#include "INETDefs.h"
+
+
+/**
+ * Replacement of cOutVector for per-connection statistics (TCP, SCTP),
+ * created via ConnStatRecorder::createVector().
+ *
+ * Values may go into an output vector, and/or into a summary statistic
+ * (cStdDev or histogram) shared by all connections of the module.
+ * The output vector object is only created when the first value is
+ * recorded, so connections which never record a value cost no
+ * output vector at all.
+ */
+class INET_API ConnStatVector
+{
+  protected:
+    std::string name;
+    bool recordVector;
+    cOutVector *vector;   // created on the first record() call
+    cStatistic *summary;  // owned by ConnStatRecorder, may be NULL
+
+  public:
+    ConnStatVector(const char *name, bool recordVector, cStatistic *summary);
+    ~ConnStatVector();
+
+    /** Records a value; same interface as cOutVector::record() */
+    bool record(double value);
+
+    /** Records a value; same interface as cOutVector::record() */
+    bool record(SimTime value) {return record(value.dbl());}
+};
+
+
+/**
+ * Decides which per-connection statistics a TCP or SCTP module records.
+ *
+ * Output vectors are only recorded for every n-th connection (sampling
+ * ratio; 1 means all connections, 0 means none). Independently of that,
+ * values of all connections can be collected into one summary statistic
+ * per statistic name (cStdDev or cDoubleHistogram), which is recorded
+ * as scalars by recordSummaries() at the end of the simulation.
+ */
+class INET_API ConnStatRecorder
+{
+  public:
+    enum SummaryMode {SUMMARY_NONE, SUMMARY_STDDEV, SUMMARY_HISTOGRAM};
+
+  protected:
+    bool enabled;
+    int vectorSamplingRatio;
+    SummaryMode summaryMode;
+    long numConnections;
+
+    typedef std::map<std::string, cStatistic *> SummaryMap;
+    SummaryMap summaries;
+
+  public:
+    ConnStatRecorder();
+    virtual ~ConnStatRecorder();
+
+    /**
+     * Sets the recording policy. summaryMode is one of "none", "stddev"
+     * and "histogram". If enabled is false, nothing gets recorded.
+     */
+    virtual void configure(bool enabled, int vectorSamplingRatio, const char *summaryMode);
+
+    /** To be called once for every new connection: returns true if it should record output vectors */
+    virtual bool selectConnection();
+
+    /**
+     * Creates a statistic for a connection, or returns NULL if the policy
+     * says nothing needs to be recorded. summaryName is the name under
+     * which values are collected for the summary (defaults to the vector
+     * name); use it when vector names contain connection identifiers.
+     */
+    virtual ConnStatVector *createVector(const char *name, bool recordVector, const char *summaryName=NULL);
+
+    /** Records the summary statistics as scalars; to be called from finish() */
+    virtual void recordSummaries();
+};
+
+#endif
+
@@ -0,0 +1,55 @@
+//
+// Copyright (C) 2009 Andras Varga
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_HASHMAP_H
+#define __INET_HASHMAP_H
+
+//
+// Portable access to the hash-based unordered_map container.
+//
+// Use it as inet_hash::unordered_map<Key, Value, KeyHash>; hash functors
+// for INET address types are usually defined next to the code that needs
+// them, as a struct with a size_t operator()(const Key&) const.
+//
+
+#if defined(_MSC_VER)
+#  include <unordered_map>
+#  if _MSC_VER < 1600
+     namespace inet_hash = std::tr1;
+#  else
+     namespace inet_hash = std;
+#  endif
+#elif __cplusplus >= 201103L
+#  include <unordered_map>
+   namespace inet_hash = std;
+#else
+#  include <tr1/unordered_map>
+   namespace inet_hash = std::tr1;
+#endif
+
+/**
+ * Mixes the bits of a 32-bit value, so that addresses differing only
+ * in a few low or high bits still spread well across hash buckets.
+ */
+inline size_t inet_hashInt(unsigned int x)
+{
+    x = ((x >> 16) ^ x) * 0x45d9f3b;
+    x = ((x >> 16) ^ x) * 0x45d9f3b;
+    return (x >> 16) ^ x;
+}
+
+#endif
@@ -49,6 +49,17 @@ typedef unsigned long ulong;
 #define EV ev.isDisabled()?ev:ev
 
 
+//
+// Lightweight Enter_Method() for frequently called methods. The method call
+// text is only formatted (and its arguments evaluated) in the GUI, where it
+// can be displayed; otherwise it is equivalent to Enter_Method_Silent().
+// Note that Tkenv formats it in express mode as well, so methods called for
+// every packet should still use cheap arguments (e.g. no str() calls).
+//
+#define Enter_Method_Lite(...)  cMethodCallContextSwitcher __ctx(this); \
+        if (ev.isGUI()) __ctx.methodCall(__VA_ARGS__); else __ctx.methodCallSilent()
+
+
 //
 // Macro to protect expressions like gate("out")->getToGate()->getToGate()
 // from crashing if something in between returns NULL.
@@ -95,8 +95,8 @@ bool NotificationBoard::hasSubscribers(int category)
 
 void NotificationBoard::fireChangeNotification(int category, const cPolymorphic *details)
 {
-    Enter_Method("fireChangeNotification(%s, %s)", notificationCategoryName(category),
-                 details?details->info().c_str() : "n/a");
+    Enter_Method_Lite("fireChangeNotification(%s, %s)", notificationCategoryName(category),
+                      details?details->info().c_str() : "n/a");
 
     ClientMap::iterator it = clientMap.find(category);
     if (it==clientMap.end())
@@ -58,7 +58,7 @@ void PassiveQueueBase::handleMessage(cMessage *msg)
 
 void PassiveQueueBase::requestPacket()
 {
-    Enter_Method("requestPacket()");
+    Enter_Method_Lite("requestPacket()");
 
     cMessage *msg = dequeue();
     if (msg==NULL)
@@ -71,6 +71,13 @@ void PassiveQueueBase::requestPacket()
     }
 }
 
+void PassiveQueueBase::receiveDirect(cMessage *msg)
+{
+    Enter_Method_Silent();
+    take(msg);
+    handleMessage(msg);
+}
+
 void PassiveQueueBase::finish()
 {
     recordScalar("packets received by queue", numQueueReceived);
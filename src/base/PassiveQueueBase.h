@@ -67,6 +67,13 @@ class INET_API PassiveQueueBase : public cSimpleModule, public IPassiveQueue
      * when one becomes available.
      */
     virtual void requestPacket();
+
+    /**
+     * Equivalent of msg arriving on the input gate, but done via a direct
+     * method call. Used by IP's fast forwarding path to enqueue datagrams
+     * without the intermediate message hops.
+     */
+    virtual void receiveDirect(cMessage *msg);
 };
 
 #endif
@@ -18,6 +18,7 @@
 #include <ctype.h>
 #include "MACAddress.h"
 #include "InterfaceToken.h"
+#include "HashMap.h"
 
 
 unsigned int MACAddress::autoAddressCtr;
@@ -161,6 +162,13 @@ int MACAddress::compareTo(const MACAddress& other) const
     return memcmp(address, other.address, MAC_ADDRESS_BYTES);
 }
 
+size_t MACAddress::hash() const
+{
+    unsigned int low = (address[2]<<24) | (address[3]<<16) | (address[4]<<8) | address[5];
+    unsigned int high = (address[0]<<8) | address[1];
+    return inet_hashInt(low ^ (high * 0x9e3779b9U));
+}
+
 InterfaceToken MACAddress::formInterfaceIdentifier() const
 {
     const unsigned char *b = address;
@@ -148,6 +148,11 @@ class INET_API MACAddress
      */
     int compareTo(const MACAddress& other) const;
 
+    /**
+     * Returns a hash value of the address, for use in hash tables.
+     */
+    size_t hash() const;
+
     /**
      * Create interface identifier (IEEE EUI-64) which can be used by IPv6
      * stateless address autoconfiguration.
@@ -162,6 +167,15 @@ class INET_API MACAddress
 
 };
 
+/**
+ * Hash functor for MACAddress, for use with inet_hash::unordered_map
+ * (see HashMap.h).
+ */
+struct MACAddressHash
+{
+    size_t operator()(const MACAddress& mac) const {return mac.hash();}
+};
+
 inline std::ostream& operator<<(std::ostream& os, const MACAddress& mac)
 {
     return os << mac.str();
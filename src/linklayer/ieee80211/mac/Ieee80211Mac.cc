@@ -16,6 +16,7 @@
 //
 
 #include <algorithm>
+#include <sstream>
 #include "Ieee80211Mac.h"
 #include "RadioState.h"
 #include "IInterfaceTable.h"
@@ -148,10 +149,22 @@ void Ieee80211Mac::initialize(int stage)
         numReceived = 0;
         numSentBroadcast = 0;
         numReceivedBroadcast = 0;
-        stateVector.setName("State");
-        stateVector.setEnum("Ieee80211Mac");
-        radioStateVector.setName("RadioState");
-        radioStateVector.setEnum("RadioState");
+
+        // tracing
+        recordStateVectors = par("recordStateVectors");
+        int timelineSize = par("stateTimelineSize");
+        if (timelineSize < 0)
+            error("stateTimelineSize must not be negative");
+        stateTimelineSize = timelineSize;
+        numStateChanges = 0;
+        if (recordStateVectors)
+        {
+            stateVector.setName("State");
+            stateVector.setEnum("Ieee80211Mac");
+            radioStateVector.setName("RadioState");
+            radioStateVector.setEnum("RadioState");
+        }
+        stateTimeline.reserve(stateTimelineSize);
 
         // initialize watches
         WATCH(fsm);
@@ -324,15 +337,14 @@ void Ieee80211Mac::handleLowerMsg(cPacket *msg)
 void Ieee80211Mac::receiveChangeNotification(int category, const cPolymorphic *details)
 {
     Enter_Method_Silent();
-    printNotificationBanner(category, details);
+    if (!ev.isDisabled())
+        printNotificationBanner(category, details);
 
     if (category == NF_RADIOSTATE_CHANGED)
     {
         RadioState::State newRadioState = check_and_cast<RadioState *>(details)->getState();
 
-        // FIXME: double recording, because there's no sample hold in the gui
-        radioStateVector.record(radioState);
-        radioStateVector.record(newRadioState);
+        traceRadioState(newRadioState);
 
         radioState = newRadioState;
 
@@ -355,8 +367,7 @@ void Ieee80211Mac::handleWithFSM(cMessage *msg)
     Ieee80211Frame *frame = dynamic_cast<Ieee80211Frame*>(msg);
     int frameType = frame ? frame->getType() : -1;
     int msgKind = msg->getKind();
-    logState();
-    stateVector.record(fsm.getState());
+    traceState();
 
     if (frame && isLowerMsg(frame))
     {
@@ -585,8 +596,7 @@ void Ieee80211Mac::handleWithFSM(cMessage *msg)
         }
     }
 
-    logState();
-    stateVector.record(fsm.getState());
+    traceState();
 }
 
 /****************************************************************
@@ -704,29 +714,38 @@ void Ieee80211Mac::scheduleReservePeriod(Ieee80211Frame *frame)
 
     // see spec. 7.1.3.2
     if (!isForUs(frame) && reserve != 0 && reserve < 32768)
-    {
-        if (endReserve->isScheduled()) {
-            simtime_t oldReserve = endReserve->getArrivalTime() - simTime();
+        extendReservePeriod(reserve);
+}
 
-            if (oldReserve > reserve)
-                return;
+void Ieee80211Mac::extendReservePeriod(simtime_t reserve)
+{
+    if (endReserve->isScheduled()) {
+        simtime_t oldReserve = endReserve->getArrivalTime() - simTime();
 
-            reserve = std::max(reserve, oldReserve);
-            cancelEvent(endReserve);
-        }
-        else if (radioState == RadioState::IDLE)
-        {
-            // NAV: the channel just became virtually busy according to the spec
-            scheduleAt(simTime(), mediumStateChange);
-        }
+        if (oldReserve > reserve)
+            return;
+
+        reserve = std::max(reserve, oldReserve);
+        cancelEvent(endReserve);
+    }
+    else if (radioState == RadioState::IDLE)
+    {
+        // NAV: the channel just became virtually busy according to the spec
+        scheduleAt(simTime(), mediumStateChange);
+    }
 
-        EV << "scheduling reserve period for: " << reserve << endl;
+    EV << "scheduling reserve period for: " << reserve << endl;
 
-        ASSERT(reserve > 0);
+    ASSERT(reserve > 0);
 
-        nav = true;
-        scheduleAt(simTime() + reserve, endReserve);
-    }
+    nav = true;
+    scheduleAt(simTime() + reserve, endReserve);
+}
+
+void Ieee80211Mac::reserveMedium(simtime_t duration)
+{
+    Enter_Method("reserveMedium(%s)", SIMTIME_STR(duration));
+    extendReservePeriod(duration);
 }
 
 void Ieee80211Mac::invalidateBackoffPeriod()
@@ -1017,6 +1036,50 @@ void Ieee80211Mac::logState()
         << ", nav = " << nav << endl;
 }
 
+void Ieee80211Mac::recordStateTimeline()
+{
+    // only state changes are recorded, to keep the timeline compact
+    short fsmState = fsm.getState();
+    if (numStateChanges > 0)
+    {
+        const StateTimelineEntry& last = stateTimeline[(numStateChanges-1) % stateTimelineSize];
+        if (last.fsmState == fsmState && last.radioState == radioState)
+            return;
+    }
+
+    StateTimelineEntry entry;
+    entry.time = simTime();
+    entry.fsmState = fsmState;
+    entry.radioState = radioState;
+    if (stateTimeline.size() < stateTimelineSize)
+        stateTimeline.push_back(entry);
+    else
+        stateTimeline[numStateChanges % stateTimelineSize] = entry;
+    numStateChanges++;
+}
+
+void Ieee80211Mac::dumpStateTimeline(std::ostream& os) const
+{
+    unsigned int n = stateTimeline.size();
+    unsigned long first = numStateChanges - n;
+    os << "state timeline (last " << n << " of " << numStateChanges << " changes):\n";
+    for (unsigned long i = first; i < numStateChanges; i++)
+    {
+        const StateTimelineEntry& entry = stateTimeline[i % stateTimelineSize];
+        os << "  t=" << entry.time << " state=" << entry.fsmState
+           << " radioState=" << entry.radioState << "\n";
+    }
+}
+
+std::string Ieee80211Mac::detailedInfo() const
+{
+    if (stateTimelineSize == 0)
+        return WirelessMacBase::detailedInfo();
+    std::stringstream out;
+    dumpStateTimeline(out);
+    return out.str();
+}
+
 const char *Ieee80211Mac::modeName(int mode)
 {
 #define CASE(x) case x: s=#x; break
@@ -21,7 +21,12 @@
 // uncomment this if you do not want to log state machine transitions
 #define FSM_DEBUG
 
+// define this to compile out FSM state tracing (state vectors, state timeline
+// and the per-event state log) completely
+//#define IEEE80211MAC_NO_TRACING
+
 #include <list>
+#include <vector>
 #include "WirelessMacBase.h"
 #include "IPassiveQueue.h"
 #include "Ieee80211Frame_m.h"
@@ -226,8 +231,27 @@ class INET_API Ieee80211Mac : public WirelessMacBase, public INotifiable
     long numReceived;
     long numSentBroadcast;
     long numReceivedBroadcast;
+    //@}
+
+  protected:
+    /**
+     * @name FSM state tracing
+     * Compiled out if IEEE80211MAC_NO_TRACING is defined, and switched on/off
+     * by the recordStateVectors and stateTimelineSize parameters.
+     */
+    //@{
+    struct StateTimelineEntry
+    {
+        simtime_t time;
+        short fsmState;
+        short radioState;
+    };
+    bool recordStateVectors;
     cOutVector stateVector;
     cOutVector radioStateVector;
+    unsigned int stateTimelineSize;         // capacity of the timeline; 0 if disabled
+    std::vector<StateTimelineEntry> stateTimeline;  // ring buffer of state changes
+    unsigned long numStateChanges;          // total number of timeline entries recorded
     //@}
 
   public:
@@ -239,6 +263,19 @@ class INET_API Ieee80211Mac : public WirelessMacBase, public INotifiable
     virtual ~Ieee80211Mac();
     //@}
 
+    /**
+     * Returns the airtime of the given frame when sent by this MAC.
+     */
+    virtual simtime_t getFrameAirtime(Ieee80211Frame *frame) {return computeFrameDuration(frame);}
+
+    /**
+     * Marks the medium busy (NAV) for the given duration from now, as if a
+     * frame was being received. Used by the analytic beacons mode of
+     * Ieee80211MgmtAP to account for the airtime of beacons that are not
+     * transmitted.
+     */
+    virtual void reserveMedium(simtime_t duration);
+
   protected:
     /**
      * @name Initialization functions
@@ -310,6 +347,9 @@ class INET_API Ieee80211Mac : public WirelessMacBase, public INotifiable
     /** @brief Schedule network allocation period according to 9.2.5.4. */
     virtual void scheduleReservePeriod(Ieee80211Frame *frame);
 
+    /** @brief Sets the network allocation period to end after reserve, unless it already ends later. */
+    virtual void extendReservePeriod(simtime_t reserve);
+
     /** @brief Generates a new backoff period based on the contention window. */
     virtual void invalidateBackoffPeriod();
     virtual bool isInvalidBackoffPeriod();
@@ -406,6 +446,42 @@ class INET_API Ieee80211Mac : public WirelessMacBase, public INotifiable
     /** @brief Logs all state information */
     virtual void logState();
 
+    /** @brief Records the FSM state for tracing; does nothing if tracing is off */
+    void traceState()
+    {
+#ifndef IEEE80211MAC_NO_TRACING
+        if (recordStateVectors)
+            stateVector.record(fsm.getState());
+        if (stateTimelineSize)
+            recordStateTimeline();
+        if (!ev.isDisabled())
+            logState();
+#endif
+    }
+
+    /** @brief Records a radio state change for tracing; does nothing if tracing is off */
+    void traceRadioState(RadioState::State newRadioState)
+    {
+#ifndef IEEE80211MAC_NO_TRACING
+        if (recordStateVectors)
+        {
+            // FIXME: double recording, because there's no sample hold in the gui
+            radioStateVector.record(radioState);
+            radioStateVector.record(newRadioState);
+        }
+#endif
+    }
+
+    /** @brief Appends the current state to the timeline, if it changed */
+    virtual void recordStateTimeline();
+
+  public:
+    /** @brief Writes the recorded state timeline, oldest entry first */
+    virtual void dumpStateTimeline(std::ostream& os) const;
+
+    /** @brief Shows the state timeline in the inspector, if enabled */
+    virtual std::string detailedInfo() const;
+
     /** @brief Produce a readable name of the given MAC operation mode */
     const char *modeName(int mode);
     //@}
@@ -0,0 +1,175 @@
+//
+// Copyright (C) 2009 Andras Varga
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include "Ieee80211BeaconService.h"
+#include "Ieee80211Mac.h"
+
+
+Ieee80211BeaconService *Ieee80211BeaconService::instance = NULL;
+int Ieee80211BeaconService::numUsers = 0;
+
+Ieee80211BeaconService *Ieee80211BeaconService::getInstance()
+{
+    if (!instance)
+        instance = new Ieee80211BeaconService();
+    numUsers++;
+    return instance;
+}
+
+void Ieee80211BeaconService::releaseInstance()
+{
+    ASSERT(numUsers > 0);
+    if (--numUsers == 0)
+    {
+        delete instance;
+        instance = NULL;
+    }
+}
+
+ChannelControl::HostRef Ieee80211BeaconService::lookupHost(cModule *mgmt)
+{
+    // hosts register themselves in ChannelControl during initialization,
+    // so this cannot be done when the AP or STA registers with us
+    std::map<cModule *, ChannelControl::HostRef>::iterator it = hostRefs.find(mgmt);
+    if (it!=hostRefs.end())
+        return it->second;
+
+    ChannelControl::HostRef hostRef = ChannelControl::get()->lookupHostContaining(mgmt);
+    if (hostRef)
+        hostRefs[mgmt] = hostRef;
+    return hostRef;
+}
+
+AbstractRadio *Ieee80211BeaconService::lookupRadio(cModule *mgmt)
+{
+    // the radio is expected next to the mgmt module, like in Ieee80211Nic
+    cModule *radio = mgmt->getParentModule()->getSubmodule("radio");
+    return dynamic_cast<AbstractRadio *>(radio);
+}
+
+void Ieee80211BeaconService::registerAP(const MACAddress& address, cModule *mgmt)
+{
+    APEntry& entry = aps[address];
+    entry.module = mgmt;
+    entry.channel = -1;
+    entry.lastBeaconTime = -1;
+}
+
+void Ieee80211BeaconService::unregisterAP(const MACAddress& address)
+{
+    APMap::iterator it = aps.find(address);
+    if (it!=aps.end())
+    {
+        hostRefs.erase(it->second.module);
+        aps.erase(it);
+    }
+}
+
+void Ieee80211BeaconService::beaconSent(const MACAddress& address, int channel)
+{
+    APMap::iterator it = aps.find(address);
+    if (it==aps.end())
+        opp_error("Ieee80211BeaconService: AP %s not registered", address.str().c_str());
+    it->second.channel = channel;
+    it->second.lastBeaconTime = simulation.getSimTime();
+}
+
+void Ieee80211BeaconService::reserveAirtime(cModule *apMgmt, int channel, simtime_t duration)
+{
+    ChannelControl::HostRef apHostRef = lookupHost(apMgmt);
+    if (!apHostRef)
+        return;
+
+    // same candidates as for a real transmission: ChannelControl's neighbours
+    ChannelControl *cc = ChannelControl::get();
+    AbstractRadio *apRadio = lookupRadio(apMgmt);
+    Coord apPos = cc->getHostPosition(apHostRef);
+    const ChannelControl::HostRefVector& neighbors = cc->getNeighbors(apHostRef);
+    for (ChannelControl::HostRefVector::const_iterator it = neighbors.begin(); it != neighbors.end(); ++it)
+    {
+        ChannelControl::HostRef h = *it;
+        if (h == apHostRef || cc->getHostChannel(h) != channel || !cc->getRadioGate(h))
+            continue;
+
+        // the radio gate of the host leads to the radio; its MAC is next to it
+        cModule *radioMod = cc->getRadioGate(h)->getPathEndGate()->getOwnerModule();
+        Ieee80211Mac *mac = dynamic_cast<Ieee80211Mac *>(radioMod->getParentModule()->getSubmodule("mac"));
+        if (!mac)
+            continue;
+
+        // the medium only becomes busy where the beacon would be received
+        AbstractRadio *radio = dynamic_cast<AbstractRadio *>(radioMod);
+        if (apRadio && radio && !radio->isReceivable(apRadio->getTransmitterPower(), apPos.distance(cc->getHostPosition(h))))
+            continue;
+
+        mac->reserveMedium(duration);
+    }
+}
+
+bool Ieee80211BeaconService::isChannelScanned(int channel) const
+{
+    std::map<int,int>::const_iterator it = numScanningSTAs.find(channel);
+    return it!=numScanningSTAs.end() && it->second > 0;
+}
+
+void Ieee80211BeaconService::scanningChannelChanged(int oldChannel, int newChannel)
+{
+    if (oldChannel!=-1)
+    {
+        ASSERT(numScanningSTAs[oldChannel] > 0);
+        numScanningSTAs[oldChannel]--;
+    }
+    if (newChannel!=-1)
+        numScanningSTAs[newChannel]++;
+}
+
+simtime_t Ieee80211BeaconService::getLastBeaconTime(const MACAddress& address, int channel, cModule *staMgmt)
+{
+    APMap::iterator it = aps.find(address);
+    if (it==aps.end())
+        return -1;
+    APEntry& entry = it->second;
+    if (entry.lastBeaconTime < 0 || entry.channel != channel)
+        return -1;
+
+    // check the STA could receive a beacon of the AP from where it is now;
+    // without radios to ask, fall back to ChannelControl's range
+    ChannelControl::HostRef apHostRef = lookupHost(entry.module);
+    ChannelControl::HostRef staHostRef = lookupHost(staMgmt);
+    if (apHostRef && staHostRef)
+    {
+        ChannelControl *cc = ChannelControl::get();
+        double distance = cc->getHostPosition(apHostRef).distance(cc->getHostPosition(staHostRef));
+        AbstractRadio *apRadio = lookupRadio(entry.module);
+        AbstractRadio *staRadio = lookupRadio(staMgmt);
+        if (apRadio && staRadio)
+        {
+            if (!staRadio->isReceivable(apRadio->getTransmitterPower(), distance))
+                return -1;
+        }
+        else if (distance > cc->getCommunicationRange(apHostRef))
+            return -1;
+    }
+    return entry.lastBeaconTime;
+}
+
+void Ieee80211BeaconService::unregisterSTA(cModule *staMgmt)
+{
+    hostRefs.erase(staMgmt);
+}
+
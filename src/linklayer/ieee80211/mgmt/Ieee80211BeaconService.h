@@ -0,0 +1,117 @@
+//
+// Copyright (C) 2009 Andras Varga
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef IEEE80211_BEACON_SERVICE_H
+#define IEEE80211_BEACON_SERVICE_H
+
+#include <map>
+#include <omnetpp.h>
+#include "INETDefs.h"
+#include "MACAddress.h"
+#include "ChannelControl.h"
+#include "AbstractRadio.h"
+#include "HashMap.h"
+
+
+/**
+ * Shared bookkeeping for the "analytic beacons" mode of Ieee80211MgmtAP
+ * and Ieee80211MgmtSTA.
+ *
+ * In this mode an AP only transmits real beacon frames while some station
+ * is scanning on its channel; otherwise it just reports each beacon here.
+ * Associated stations do not receive the beacons, instead they consult
+ * this class when their beacon timeout expires, and only declare the AP
+ * lost if it has not beaconed recently, or the STA's radio could not
+ * receive a frame sent with the AP's transmitter power from the current
+ * distance.
+ *
+ * The single instance is shared by all APs and STAs in the simulation;
+ * it is created by the first getInstance() call, and destroyed when the
+ * last user calls releaseInstance().
+ *
+ * @author Andras Varga
+ */
+class INET_API Ieee80211BeaconService
+{
+  protected:
+    struct APEntry
+    {
+        cModule *module;
+        int channel;
+        simtime_t lastBeaconTime;         // time of the last analytic beacon, or -1
+    };
+
+    typedef inet_hash::unordered_map<MACAddress, APEntry, MACAddressHash> APMap;
+
+    APMap aps;
+    std::map<int,int> numScanningSTAs;  // channel -> number of STAs scanning it
+    std::map<cModule *, ChannelControl::HostRef> hostRefs; // mgmt module -> its host in ChannelControl
+
+    static Ieee80211BeaconService *instance;
+    static int numUsers;
+
+  protected:
+    Ieee80211BeaconService() {}
+    virtual ~Ieee80211BeaconService() {}
+    virtual ChannelControl::HostRef lookupHost(cModule *mgmt);
+    virtual AbstractRadio *lookupRadio(cModule *mgmt);
+
+  public:
+    /** Returns the shared instance, creating it if needed. Pair with releaseInstance(). */
+    static Ieee80211BeaconService *getInstance();
+
+    /** Releases the shared instance; the last call deletes it */
+    static void releaseInstance();
+
+    /** @name Called by APs */
+    //@{
+    virtual void registerAP(const MACAddress& address, cModule *mgmt);
+    virtual void unregisterAP(const MACAddress& address);
+
+    /** Records a beacon that was not transmitted as a frame */
+    virtual void beaconSent(const MACAddress& address, int channel);
+
+    /**
+     * Marks the medium busy for the given duration at the MAC of every other
+     * node on the channel that would receive a beacon of the given AP, like
+     * a transmitted beacon would. The AP's own MAC is not affected.
+     */
+    virtual void reserveAirtime(cModule *apMgmt, int channel, simtime_t duration);
+
+    /** Returns true if real beacons are needed on the channel, because some STA is scanning it */
+    virtual bool isChannelScanned(int channel) const;
+    //@}
+
+    /** @name Called by STAs */
+    //@{
+    /** Updates the channel the STA is scanning; -1 means not scanning */
+    virtual void scanningChannelChanged(int oldChannel, int newChannel);
+
+    /**
+     * Returns the time of the last analytic beacon of the given AP on the
+     * given channel that the STA could have received, or -1 if there was
+     * none or the AP is out of range.
+     */
+    virtual simtime_t getLastBeaconTime(const MACAddress& address, int channel, cModule *staMgmt);
+
+    /** Forgets cached data about the STA */
+    virtual void unregisterSTA(cModule *staMgmt);
+    //@}
+};
+
+#endif
+
@@ -21,6 +21,8 @@
 #include "EtherFrame_m.h"
 #include "NotifierConsts.h"
 #include "RadioState.h"
+#include "Ieee80211BeaconService.h"
+#include "Ieee80211Mac.h"
 
 
 Define_Module(Ieee80211MgmtAP);
@@ -31,6 +33,14 @@ static std::ostream& operator<< (std::ostream& os, const Ieee80211MgmtAP::STAInf
     return os;
 }
 
+static std::ostream& operator<< (std::ostream& os, const Ieee80211MgmtAP::STAList& staList)
+{
+    os << staList.size() << " STAs:";
+    for (Ieee80211MgmtAP::STAList::const_iterator it = staList.begin(); it != staList.end(); ++it)
+        os << " " << it->first << "(" << it->second << ")";
+    return os;
+}
+
 void Ieee80211MgmtAP::initialize(int stage)
 {
     Ieee80211MgmtAPBase::initialize(stage);
@@ -40,6 +50,7 @@ void Ieee80211MgmtAP::initialize(int stage)
         // read params and init vars
         ssid = par("ssid").stringValue();
         beaconInterval = par("beaconInterval");
+        analyticBeacons = par("analyticBeacons");
         numAuthSteps = par("numAuthSteps");
         if (numAuthSteps!=2 && numAuthSteps!=4)
             error("parameter 'numAuthSteps' (number of frames exchanged during authentication) must be 2 or 4, not %d", numAuthSteps);
@@ -48,7 +59,11 @@ void Ieee80211MgmtAP::initialize(int stage)
         WATCH(channelNumber);
         WATCH(beaconInterval);
         WATCH(numAuthSteps);
-        WATCH_MAP(staList);
+        WATCH(staList);
+
+        numBeaconsSent = numAnalyticBeacons = 0;
+        WATCH(numBeaconsSent);
+        WATCH(numAnalyticBeacons);
 
         //TBD fill in supportedRates
 
@@ -60,13 +75,41 @@ void Ieee80211MgmtAP::initialize(int stage)
         beaconTimer = new cMessage("beaconTimer");
         scheduleAt(simTime()+uniform(0,beaconInterval), beaconTimer);
     }
+    else if (stage==1)
+    {
+        // myAddress is only known from stage 1
+        if (analyticBeacons)
+        {
+            beaconService = Ieee80211BeaconService::getInstance();
+            beaconService->registerAP(myAddress, this);
+            mac = check_and_cast<Ieee80211Mac *>(getParentModule()->getSubmodule("mac"));
+        }
+    }
+}
+
+Ieee80211MgmtAP::~Ieee80211MgmtAP()
+{
+    cancelAndDelete(beaconTimer);
+    if (beaconService)
+    {
+        beaconService->unregisterAP(myAddress);
+        Ieee80211BeaconService::releaseInstance();
+    }
+}
+
+void Ieee80211MgmtAP::finish()
+{
+    Ieee80211MgmtAPBase::finish();
+    recordScalar("beacons sent", numBeaconsSent);
+    if (analyticBeacons)
+        recordScalar("analytic beacons", numAnalyticBeacons);
 }
 
 void Ieee80211MgmtAP::handleTimer(cMessage *msg)
 {
     if (msg==beaconTimer)
     {
-        sendBeacon();
+        handleBeaconTimer();
         scheduleAt(simTime()+beaconInterval, beaconTimer);
     }
     else
@@ -126,9 +169,30 @@ void Ieee80211MgmtAP::sendManagementFrame(Ieee80211ManagementFrame *frame, const
     sendOrEnqueue(frame);
 }
 
-void Ieee80211MgmtAP::sendBeacon()
+void Ieee80211MgmtAP::handleBeaconTimer()
+{
+    // in analytic mode, real beacons are only needed by stations scanning
+    // our channel; associated stations ask beaconService instead
+    if (beaconService && !beaconService->isChannelScanned(channelNumber))
+    {
+        EV << "Nobody is scanning channel " << channelNumber << ", recording analytic beacon\n";
+        beaconService->beaconSent(myAddress, channelNumber);
+        numAnalyticBeacons++;
+
+        // the beacon is not transmitted, but the nodes in range still
+        // find the medium busy for its airtime
+        Ieee80211BeaconFrame *frame = createBeacon();
+        beaconService->reserveAirtime(this, channelNumber, mac->getFrameAirtime(frame));
+        delete frame;
+    }
+    else
+    {
+        sendBeacon();
+    }
+}
+
+Ieee80211BeaconFrame *Ieee80211MgmtAP::createBeacon()
 {
-    EV << "Sending beacon\n";
     Ieee80211BeaconFrame *frame = new Ieee80211BeaconFrame("Beacon");
     Ieee80211BeaconFrameBody& body = frame->getBody();
     body.setSSID(ssid.c_str());
@@ -138,8 +202,14 @@ void Ieee80211MgmtAP::sendBeacon()
 
     frame->setReceiverAddress(MACAddress::BROADCAST_ADDRESS);
     frame->setFromDS(true);
+    return frame;
+}
 
-    sendOrEnqueue(frame);
+void Ieee80211MgmtAP::sendBeacon()
+{
+    EV << "Sending beacon\n";
+    numBeaconsSent++;
+    sendOrEnqueue(createBeacon());
 }
 
 void Ieee80211MgmtAP::handleDataFrame(Ieee80211DataFrame *frame)
@@ -19,9 +19,12 @@
 #define IEEE80211_MGMT_AP_H
 
 #include <omnetpp.h>
-#include <map>
 #include "Ieee80211MgmtAPBase.h"
 #include "NotificationBoard.h"
+#include "HashMap.h"
+
+class Ieee80211BeaconService;
+class Ieee80211Mac;
 
 
 /**
@@ -45,26 +48,35 @@ class INET_API Ieee80211MgmtAP : public Ieee80211MgmtAPBase
         //double expiry;          //XXX association should expire after a while if STA is silent?
     };
 
-    struct MAC_compare {
-        bool operator()(const MACAddress& u1, const MACAddress& u2) const {return u1.compareTo(u2) < 0;}
-    };
-    typedef std::map<MACAddress,STAInfo, MAC_compare> STAList;
+    typedef inet_hash::unordered_map<MACAddress, STAInfo, MACAddressHash> STAList;
 
   protected:
     // configuration
     std::string ssid;
     int channelNumber;
     simtime_t beaconInterval;
+    bool analyticBeacons;
     int numAuthSteps;
     Ieee80211SupportedRatesElement supportedRates;
 
     // state
     STAList staList; ///< list of STAs
     cMessage *beaconTimer;
+    Ieee80211BeaconService *beaconService; // only in analyticBeacons mode
+    Ieee80211Mac *mac; // only in analyticBeacons mode, to compute the airtime of analytic beacons
+
+    // statistics
+    long numBeaconsSent;
+    long numAnalyticBeacons;
+
+  public:
+    Ieee80211MgmtAP() {beaconTimer = NULL; beaconService = NULL; mac = NULL;}
+    virtual ~Ieee80211MgmtAP();
 
   protected:
     virtual int numInitStages() const {return 2;}
     virtual void initialize(int);
+    virtual void finish();
 
     /** Implements abstract Ieee80211MgmtBase method */
     virtual void handleTimer(cMessage *msg);
@@ -84,9 +96,15 @@ class INET_API Ieee80211MgmtAP : public Ieee80211MgmtAPBase
     /** Utility function: set fields in the given frame and send it out to the address */
     virtual void sendManagementFrame(Ieee80211ManagementFrame *frame, const MACAddress& destAddr);
 
+    /** Utility function: creates a beacon frame */
+    virtual Ieee80211BeaconFrame *createBeacon();
+
     /** Utility function: creates and sends a beacon frame */
     virtual void sendBeacon();
 
+    /** Utility function: sends a beacon frame, or only records it in analyticBeacons mode if nobody is scanning */
+    virtual void handleBeaconTimer();
+
     /** @name Processing of different frame types */
     //@{
     virtual void handleDataFrame(Ieee80211DataFrame *frame);
@@ -22,6 +22,7 @@
 #include "PhyControlInfo_m.h"
 #include "RadioState.h"
 #include "ChannelControl.h"
+#include "Ieee80211BeaconService.h"
 
 //TBD supportedRates!
 //TBD use command msg kinds?
@@ -94,6 +95,11 @@ void Ieee80211MgmtSTA::initialize(int stage)
         isAssociated = false;
         assocTimeoutMsg = NULL;
 
+        staleAPTimeout = par("staleAPTimeout");
+        analyticBeacons = par("analyticBeacons");
+        if (analyticBeacons)
+            beaconService = Ieee80211BeaconService::getInstance();
+
         nb = NotificationBoardAccess().get();
 
         // determine numChannels (needed when we're told to scan "all" channels)
@@ -110,6 +116,16 @@ void Ieee80211MgmtSTA::initialize(int stage)
     }
 }
 
+Ieee80211MgmtSTA::~Ieee80211MgmtSTA()
+{
+    if (beaconService)
+    {
+        setScanningChannel(-1);
+        beaconService->unregisterSTA(this);
+        Ieee80211BeaconService::releaseInstance();
+    }
+}
+
 void Ieee80211MgmtSTA::handleTimer(cMessage *msg)
 {
     if (msg->getKind()==MK_AUTH_TIMEOUT)
@@ -167,7 +183,7 @@ void Ieee80211MgmtSTA::handleTimer(cMessage *msg)
     else if (msg->getKind()==MK_BEACON_TIMEOUT)
     {
         // missed a few consecutive beacons
-        beaconLost();
+        handleBeaconTimeout();
     }
     else
     {
@@ -223,10 +239,8 @@ Ieee80211DataFrame *Ieee80211MgmtSTA::encapsulate(cPacket *msg)
 
 Ieee80211MgmtSTA::APInfo *Ieee80211MgmtSTA::lookupAP(const MACAddress& address)
 {
-    for (AccessPointList::iterator it=apList.begin(); it!=apList.end(); ++it)
-        if (it->address == address)
-            return &(*it);
-    return NULL;
+    AccessPointIndex::iterator it = apIndex.find(address);
+    return it==apIndex.end() ? NULL : &(*it->second);
 }
 
 void Ieee80211MgmtSTA::clearAPList()
@@ -235,6 +249,41 @@ void Ieee80211MgmtSTA::clearAPList()
         if (it->authTimeoutMsg)
             delete cancelEvent(it->authTimeoutMsg);
     apList.clear();
+    apIndex.clear();
+    apExpiryList.clear();
+}
+
+bool Ieee80211MgmtSTA::isAPInUse(APInfo *ap)
+{
+    return ap->authTimeoutMsg || ap->isAuthenticated
+        || (assocTimeoutMsg && assocTimeoutMsg->getContextPointer()==ap)
+        || (isAssociated && assocAP.address==ap->address);
+}
+
+void Ieee80211MgmtSTA::purgeStaleAPs()
+{
+    if (staleAPTimeout==0)
+        return;
+
+    // apExpiryList is ordered by lastHeard, so stale entries are at the front;
+    // APs still in use are moved to the back instead of being removed
+    simtime_t expiryTime = simTime() - staleAPTimeout;
+    int n = apExpiryList.size();
+    for (int i=0; i<n && apExpiryList.front()->lastHeard < expiryTime; i++)
+    {
+        APInfo *ap = apExpiryList.front();
+        if (isAPInUse(ap))
+        {
+            apExpiryList.splice(apExpiryList.end(), apExpiryList, apExpiryList.begin());
+            continue;
+        }
+
+        EV << "AP address=" << ap->address << " not heard from since t=" << ap->lastHeard << ", removing it from our AP list\n";
+        apExpiryList.pop_front();
+        AccessPointIndex::iterator it = apIndex.find(ap->address);
+        apList.erase(it->second);
+        apIndex.erase(it);
+    }
 }
 
 void Ieee80211MgmtSTA::changeChannel(int channelNum)
@@ -255,6 +304,32 @@ void Ieee80211MgmtSTA::beaconLost()
     nb->fireChangeNotification(NF_L2_BEACON_LOST, NULL);  //XXX use InterfaceEntry as detail, etc...
 }
 
+void Ieee80211MgmtSTA::handleBeaconTimeout()
+{
+    if (beaconService)
+    {
+        // beacons may have been recorded analytically instead of being sent
+        simtime_t lastBeaconTime = beaconService->getLastBeaconTime(assocAP.address, assocAP.channel, this);
+        simtime_t timeout = lastBeaconTime + MAX_BEACONS_MISSED*assocAP.beaconInterval;
+        if (lastBeaconTime >= 0 && timeout > simTime())
+        {
+            EV << "AP sent analytic beacon at t=" << lastBeaconTime << ", restarting beacon timeout timer\n";
+            scheduleAt(timeout, assocAP.beaconTimeoutMsg);
+            return;
+        }
+    }
+    beaconLost();
+}
+
+void Ieee80211MgmtSTA::setScanningChannel(int channel)
+{
+    if (beaconService && channel!=scanningChannel)
+    {
+        beaconService->scanningChannelChanged(scanningChannel, channel);
+        scanningChannel = channel;
+    }
+}
+
 void Ieee80211MgmtSTA::sendManagementFrame(Ieee80211ManagementFrame *frame, const MACAddress& address)
 {
     // frame goes to the specified AP
@@ -389,12 +464,14 @@ bool Ieee80211MgmtSTA::scanNextChannel()
         if (scanning.activeScan)
             nb->unsubscribe(this, NF_RADIOSTATE_CHANGED);
         isScanning = false;
+        setScanningChannel(-1);
         return true; // we're done
     }
 
     // tune to next channel
     int newChannel = scanning.channelList[++scanning.currentChannelIndex];
     changeChannel(newChannel);
+    setScanningChannel(newChannel);
     scanning.busyChannelDetected = false;
 
     if (scanning.activeScan)
@@ -423,6 +500,8 @@ void Ieee80211MgmtSTA::sendProbeRequest()
 
 void Ieee80211MgmtSTA::sendScanConfirm()
 {
+    purgeStaleAPs();
+
     EV << "Scanning complete, found " << apList.size() << " APs, sending confirmation to agent\n";
 
     // copy apList contents into a ScanConfirm primitive and send it back
@@ -795,13 +874,17 @@ void Ieee80211MgmtSTA::storeAPInfo(const MACAddress& address, const Ieee80211Bea
     if (ap)
     {
         EV << "AP address=" << address << ", SSID=" << body.getSSID() << " already in our AP list, refreshing the info\n";
+        apExpiryList.splice(apExpiryList.end(), apExpiryList, ap->expiryPos);
     }
     else
     {
         EV << "Inserting AP address=" << address << ", SSID=" << body.getSSID() << " into our AP list\n";
         apList.push_back(APInfo());
         ap = &apList.back();
+        apIndex[address] = --apList.end();
+        ap->expiryPos = apExpiryList.insert(apExpiryList.end(), ap);
     }
+    ap->lastHeard = simTime();
 
     ap->channel = body.getChannelNumber();
     ap->address = address;
@@ -811,5 +894,7 @@ void Ieee80211MgmtSTA::storeAPInfo(const MACAddress& address, const Ieee80211Bea
 
     //XXX where to get this from?
     //ap->rxPower = ...
+
+    purgeStaleAPs();
 }
 
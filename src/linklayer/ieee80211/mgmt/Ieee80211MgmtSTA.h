@@ -19,9 +19,13 @@
 #define IEEE80211_MGMT_STA_H
 
 #include <omnetpp.h>
+#include <list>
 #include "Ieee80211MgmtBase.h"
 #include "NotificationBoard.h"
 #include "Ieee80211Primitives_m.h"
+#include "HashMap.h"
+
+class Ieee80211BeaconService;
 
 
 /**
@@ -65,6 +69,9 @@ class INET_API Ieee80211MgmtSTA : public Ieee80211MgmtBase
         int authSeqExpected;  // valid while authenticating; values: 1,3,5...
         cMessage *authTimeoutMsg; // if non-NULL: authentication is in progress
 
+        simtime_t lastHeard; // time of the last beacon or probe response
+        std::list<APInfo *>::iterator expiryPos; // position in the expiry list
+
         APInfo() {
             channel=-1; beaconInterval=rxPower=0; authSeqExpected=-1;
             isAuthenticated=false; authTimeoutMsg=NULL;
@@ -92,16 +99,34 @@ class INET_API Ieee80211MgmtSTA : public Ieee80211MgmtBase
     bool isScanning;
     ScanningInfo scanning;
 
+    // analytic beacons mode: see Ieee80211BeaconService
+    bool analyticBeacons;
+    Ieee80211BeaconService *beaconService;
+    int scanningChannel; // channel we reported to beaconService as being scanned, or -1
+
     // APInfo list: we collect scanning results and keep track of ongoing authentications here
     // Note: there can be several ongoing authentications simultaneously
     typedef std::list<APInfo> AccessPointList;
     AccessPointList apList;
 
+    // index into apList by AP address
+    typedef inet_hash::unordered_map<MACAddress, AccessPointList::iterator, MACAddressHash> AccessPointIndex;
+    AccessPointIndex apIndex;
+
+    // apList elements in the order they were last heard, for expiring stale APs
+    typedef std::list<APInfo *> AccessPointExpiryList;
+    AccessPointExpiryList apExpiryList;
+    simtime_t staleAPTimeout; // APs not heard from for this long are removed; 0 means never
+
     // associated Access Point
     bool isAssociated;
     cMessage *assocTimeoutMsg; // if non-NULL: association is in progress
     AssociatedAPInfo assocAP;
 
+  public:
+    Ieee80211MgmtSTA() {beaconService = NULL; scanningChannel = -1;}
+    virtual ~Ieee80211MgmtSTA();
+
   protected:
     virtual int numInitStages() const {return 2;}
     virtual void initialize(int);
@@ -130,6 +155,12 @@ class INET_API Ieee80211MgmtSTA : public Ieee80211MgmtBase
     /** Utility function: clear the AP list, and cancel any pending authentications. */
     virtual void clearAPList();
 
+    /** Utility function: remove APs not heard from for staleAPTimeout, unless authenticating or associating with them */
+    virtual void purgeStaleAPs();
+
+    /** Utility function: returns true if the AP is referenced by an ongoing authentication or association */
+    virtual bool isAPInUse(APInfo *ap);
+
     /** Utility function: switches to the given radio channel. */
     virtual void changeChannel(int channelNum);
 
@@ -145,6 +176,12 @@ class INET_API Ieee80211MgmtSTA : public Ieee80211MgmtBase
     /** Missed a few consecutive beacons */
     virtual void beaconLost();
 
+    /** Beacon timeout expired; in analyticBeacons mode, checks beaconService before calling beaconLost() */
+    virtual void handleBeaconTimeout();
+
+    /** Tells beaconService which channel we're scanning (-1: none), in analyticBeacons mode */
+    virtual void setScanningChannel(int channel);
+
     /** Sends back result of scanning to the agent */
     virtual void sendScanConfirm();
 
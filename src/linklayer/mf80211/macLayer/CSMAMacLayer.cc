@@ -265,8 +265,8 @@ MacPkt *CSMAMacLayer::encapsMsg(cPacket *netw)
  */
 void CSMAMacLayer::receiveChangeNotification(int category, const cPolymorphic *details)
 {
-    Enter_Method("receiveChangeNotification(%s, %s)", notificationCategoryName(category),
-                 details?details->info().c_str() : "n/a");
+    Enter_Method_Lite("receiveChangeNotification(%s, %s)", notificationCategoryName(category),
+                      details?details->info().c_str() : "n/a");
     printNotificationBanner(category, details);
 
     if (category == NF_RADIOSTATE_CHANGED)
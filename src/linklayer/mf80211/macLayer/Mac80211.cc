@@ -913,8 +913,8 @@ void Mac80211::testMaxAttempts()
  */
 void Mac80211::receiveChangeNotification(int category, const cPolymorphic *details)
 {
-    Enter_Method("receiveChangeNotification(%s, %s)", notificationCategoryName(category),
-                 details?details->info().c_str() : "n/a");
+    Enter_Method_Lite("receiveChangeNotification(%s, %s)", notificationCategoryName(category),
+                      details?details->info().c_str() : "n/a");
     printNotificationBanner(category, details);
 
     if (category == NF_RADIOSTATE_CHANGED)
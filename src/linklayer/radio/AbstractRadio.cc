@@ -25,12 +25,14 @@
 
 #define MK_TRANSMISSION_OVER  1
 #define MK_RECEPTION_COMPLETE 2
+#define MK_NOISE_EXPIRED      3
 
 
 AbstractRadio::AbstractRadio() : rs(this->getId())
 {
     radioModel = NULL;
     receptionModel = NULL;
+    noiseTimer = NULL;
 }
 
 void AbstractRadio::initialize(int stage)
@@ -55,6 +57,8 @@ void AbstractRadio::initialize(int stage)
         thermalNoise = FWMath::dBm2mW(par("thermalNoise"));
         carrierFrequency = cc->par("carrierFrequency");  // taken from ChannelControl
         sensitivity = FWMath::dBm2mW(par("sensitivity"));
+        lazyNoiseExpiry = par("lazyNoiseExpiry");
+        noiseTimer = new cMessage("noiseExpired", MK_NOISE_EXPIRED);
 
         // initialize noiseLevel
         noiseLevel = thermalNoise;
@@ -107,6 +111,7 @@ AbstractRadio::~AbstractRadio()
 {
     delete radioModel;
     delete receptionModel;
+    cancelAndDelete(noiseTimer);
 
     // delete messages being received
     for (RecvBuff::iterator it = recvBuff.begin(); it!=recvBuff.end(); ++it)
@@ -172,6 +177,16 @@ void AbstractRadio::handleMessage(cMessage *msg)
  */
 void AbstractRadio::bufferMsg(AirFrame *airframe) //FIXME: add explicit simtime_t atTime arg?
 {
+    if (lazyNoiseExpiry && snrInfo.ptr != airframe)
+    {
+        // noise: only its power and end time are needed, no end-of-reception event
+        noiseBuff.insert(std::make_pair(airframe->getArrivalTime() + airframe->getDuration(), recvBuff[airframe]));
+        recvBuff.erase(airframe);
+        delete airframe;
+        updateNoiseTimer();
+        return;
+    }
+
     // set timer to indicate transmission is complete
     cMessage *endRxTimer = new cMessage("endRx", MK_RECEPTION_COMPLETE);
     endRxTimer->setContextPointer(airframe);
@@ -230,6 +245,52 @@ AirFrame *AbstractRadio::unbufferMsg(cMessage *msg)
     return airframe;
 }
 
+/**
+ * Does what handleLowerMsgEnd() does for noise frames, for all noise
+ * frames in noiseBuff which ended by now, in the order they ended. SNR
+ * entries get the time the noise ended, so the result is the same as
+ * with end-of-reception events.
+ */
+void AbstractRadio::expireNoise()
+{
+    if (noiseBuff.empty() || noiseBuff.begin()->first > simTime())
+        return;
+
+    while (!noiseBuff.empty() && noiseBuff.begin()->first <= simTime())
+    {
+        NoiseBuff::iterator it = noiseBuff.begin();
+        noiseLevel -= it->second;
+
+        // update snr info for message currently being received if any
+        if (snrInfo.ptr != NULL)
+        {
+            SnrListEntry listEntry;
+            listEntry.time = it->first;
+            listEntry.snr = snrInfo.rcvdPower / noiseLevel;
+            snrInfo.sList.push_back(listEntry);
+        }
+        noiseBuff.erase(it);
+    }
+    updateNoiseTimer();
+}
+
+void AbstractRadio::updateNoiseTimer()
+{
+    // while the noise level is below sensitivity, noise ending cannot change the radio state
+    if (noiseLevel >= sensitivity && !noiseBuff.empty())
+    {
+        simtime_t nextExpiry = noiseBuff.begin()->first;
+        if (noiseTimer->isScheduled() && noiseTimer->getArrivalTime() == nextExpiry)
+            return;
+        cancelEvent(noiseTimer);
+        scheduleAt(nextExpiry, noiseTimer);
+    }
+    else if (noiseTimer->isScheduled())
+    {
+        cancelEvent(noiseTimer);
+    }
+}
+
 /**
  * If a message is already being transmitted, an error is raised.
  *
@@ -246,6 +307,8 @@ void AbstractRadio::handleUpperMsg(AirFrame *airframe)
         error("Trying to send a message while already transmitting -- MAC should "
               "take care this does not happen");
 
+    expireNoise();
+
     // if a packet was being received, it is corrupted now as should be treated as noise
     if (snrInfo.ptr != NULL)
     {
@@ -261,6 +324,7 @@ void AbstractRadio::handleUpperMsg(AirFrame *airframe)
         snrInfo.sList.clear();
         // add the receive power to the noise level
         noiseLevel += snrInfo.rcvdPower;
+        updateNoiseTimer();
     }
 
     // now we are done with all the exception handling and can take care
@@ -331,6 +395,8 @@ void AbstractRadio::handleSelfMsg(cMessage *msg)
     }
     else if (msg->getKind() == MK_TRANSMISSION_OVER)
     {
+        expireNoise();
+
         // Transmission has completed. The RadioState has to be changed
         // to IDLE or RECV, based on the noise level on the channel.
         // If the noise level is bigger than the sensitivity switch to receive mode,
@@ -358,6 +424,17 @@ void AbstractRadio::handleSelfMsg(cMessage *msg)
             newChannel = -1;
         }
     }
+    else if (msg->getKind() == MK_NOISE_EXPIRED)
+    {
+        expireNoise();
+
+        // same as at the end of handleLowerMsgEnd()
+        if (noiseLevel < sensitivity && rs.getState() == RadioState::RECV && snrInfo.ptr == NULL)
+        {
+            EV << "noise is over, new RadioState is IDLE\n";
+            setRadioState(RadioState::IDLE);
+        }
+    }
     else
     {
         error("Internal error: unknown self-message `%s'", msg->getName());
@@ -390,6 +467,8 @@ void AbstractRadio::handleSelfMsg(cMessage *msg)
  */
 void AbstractRadio::handleLowerMsgStart(AirFrame * airframe)
 {
+    expireNoise();
+
     // Calculate the receive power of the message
 
     // calculate distance
@@ -466,6 +545,8 @@ void AbstractRadio::handleLowerMsgStart(AirFrame * airframe)
  */
 void AbstractRadio::handleLowerMsgEnd(AirFrame * airframe)
 {
+    expireNoise();
+
     // check if message has to be send to the decider
     if (snrInfo.ptr == airframe)
     {
@@ -525,6 +606,7 @@ void AbstractRadio::handleLowerMsgEnd(AirFrame * airframe)
         EV << "new RadioState is IDLE\n";
         setRadioState(RadioState::IDLE);
     }
+    updateNoiseTimer();
 }
 
 void AbstractRadio::addNewSnr()
@@ -535,6 +617,11 @@ void AbstractRadio::addNewSnr()
     snrInfo.sList.push_back(listEntry);
 }
 
+bool AbstractRadio::isReceivable(double pSend, double distance)
+{
+    return receptionModel->calculateReceivedPower(pSend, carrierFrequency, distance) >= sensitivity;
+}
+
 void AbstractRadio::changeChannel(int channel)
 {
     if (channel == rs.getChannelNumber())
@@ -556,6 +643,8 @@ void AbstractRadio::changeChannel(int channel)
             delete cancelEvent(endRxTimer);
         }
         recvBuff.clear();
+        noiseBuff.clear();
+        updateNoiseTimer();
     }
 
     // clear snr info
@@ -578,7 +667,7 @@ void AbstractRadio::changeChannel(int channel)
     {
         AirFrame *airframe = *it;
         // time for the message to reach us
-        double distance = myHostRef->pos.distance(airframe->getSenderPos());
+        double distance = getMyPosition().distance(airframe->getSenderPos());
         simtime_t propagationDelay = distance / LIGHT_SPEED;
 
         // if this transmission is on our new channel and it would reach us in the future, then schedule it
@@ -59,6 +59,15 @@ class INET_API AbstractRadio : public ChannelAccess
     AbstractRadio();
     virtual ~AbstractRadio();
 
+    /** Returns the transmitter power in mW */
+    double getTransmitterPower() const {return transmitterPower;}
+
+    /**
+     * Returns true if a frame sent with the given power (mW) from the given
+     * distance would be received with a power at or above the sensitivity.
+     */
+    virtual bool isReceivable(double pSend, double distance);
+
   protected:
     virtual void initialize(int stage);
     virtual void finish();
@@ -83,6 +92,12 @@ class INET_API AbstractRadio : public ChannelAccess
     /** @brief Unbuffers a message after 'transmission time' */
     virtual AirFrame *unbufferMsg(cMessage *msg);
 
+    /** @brief With lazyNoiseExpiry: removes the power of noise frames that have ended from the noise level */
+    virtual void expireNoise();
+
+    /** @brief With lazyNoiseExpiry: schedules noiseTimer if the end of noise may change the radio state */
+    virtual void updateNoiseTimer();
+
     /** Sends a message to the upper layer */
     virtual void sendUp(AirFrame *airframe);
 
@@ -176,6 +191,28 @@ class INET_API AbstractRadio : public ChannelAccess
      */
     RecvBuff recvBuff;
 
+    /** Configuration: if true, noise frames get no end-of-reception event, see noiseBuff */
+    bool lazyNoiseExpiry;
+
+    /**
+     * Typedef used to store the end time and receive power of noise
+     * frames, with lazyNoiseExpiry.
+     */
+    typedef std::multimap<simtime_t,double> NoiseBuff;
+
+    /**
+     * State: with lazyNoiseExpiry, frames that are only noise are deleted
+     * on arrival and only their end time and power are kept here, until
+     * expireNoise() removes them. Frames being received stay in recvBuff.
+     */
+    NoiseBuff noiseBuff;
+
+    /**
+     * State: with lazyNoiseExpiry, fires when the next noise frame ends,
+     * if that may make the radio state IDLE again.
+     */
+    cMessage *noiseTimer;
+
     /** State: the current RadioState of the NIC; includes channel number */
     RadioState rs;
 
@@ -22,17 +22,6 @@
 Define_Module(ANSimMobility);
 
 
-static cXMLElement *firstChildWithTag(cXMLElement *node, const char *tagname)
-{
-    cXMLElement *child = node->getFirstChild();
-    while (child && strcmp(child->getTagName(), tagname)!=0)
-        child = child->getNextSibling();
-    if (!child)
-        opp_error("element <%s> has no <%s> child at %s", node->getTagName(), tagname, node->getSourceLocation());
-    return child;
-}
-
-
 void ANSimMobility::initialize(int stage)
 {
     LineSegmentsMobilityBase::initialize(stage);
@@ -46,14 +35,8 @@ void ANSimMobility::initialize(int stage)
             nodeId = getParentModule()->getIndex();
 
         // get script: param should point to <simulation> element
-        cXMLElement *rootElem = par("ansimTrace");
-        if (strcmp(rootElem->getTagName(),"simulation")!=0)
-            error("ansimTrace: <simulation> is expected as root element not <%s> at %s",
-                  rootElem->getTagName(), rootElem->getSourceLocation());
-        nextPosChange = rootElem->getElementByPath("mobility/position_change");
-        if (!nextPosChange)
-            error("element doesn't have <mobility> child or <position_change> grandchild at %s",
-                  rootElem->getSourceLocation());
+        waypoints = &ANSimTraceCache::getInstance()->getTrace(par("ansimTrace").xmlValue())->getWaypoints(nodeId);
+        nextWaypoint = 0;
 
         // set initial position;
         setTargetPosition();
@@ -63,46 +46,23 @@ void ANSimMobility::initialize(int stage)
 }
 
 
-void ANSimMobility::setTargetPosition()
+ANSimMobility::~ANSimMobility()
 {
-    // find next <position_update> element with matching <node_id> tag (current one also OK)
-    while (nextPosChange)
-    {
-        const char *nodeIdStr = firstChildWithTag(nextPosChange, "node_id")->getNodeValue();
-        if (nodeIdStr && atoi(nodeIdStr)==nodeId)
-            break;
-        nextPosChange = nextPosChange->getNextSibling();
-    }
+    ANSimTraceCache::deleteInstance();
+}
 
-    if (!nextPosChange)
+void ANSimMobility::setTargetPosition()
+{
+    if (nextWaypoint >= waypoints->size())
     {
         stationary = true;
         return;
     }
 
-    // extract data from it
-    extractDataFrom(nextPosChange);
-
-    // skip this one
-    nextPosChange = nextPosChange->getNextSibling();
-}
-
-void ANSimMobility::extractDataFrom(cXMLElement *node)
-{
-    // extract data from <position_update> element
-    // FIXME start_time has to be taken into account too! as pause from prev element's end_time
-    const char *startTimeStr = firstChildWithTag(node, "start_time")->getNodeValue();
-    const char *endTimeStr = firstChildWithTag(node, "end_time")->getNodeValue();
-    cXMLElement *destElem = firstChildWithTag(node, "destination");
-    const char *xStr = firstChildWithTag(destElem, "xpos")->getNodeValue();
-    const char *yStr = firstChildWithTag(destElem, "ypos")->getNodeValue();
-
-    if (!endTimeStr || !xStr || !yStr)
-        error("no content in <end_time>, <destination>/<xpos> or <ypos> element at %s", node->getSourceLocation());
-
-    targetTime = atof(endTimeStr);
-    targetPos.x = atof(xStr);
-    targetPos.y = atof(yStr);
+    const ANSimTrace::Waypoint& wp = (*waypoints)[nextWaypoint++];
+    targetTime = wp.endTime;
+    targetPos.x = wp.x;
+    targetPos.y = wp.y;
 }
 
 void ANSimMobility::fixIfHostGetsOutside()
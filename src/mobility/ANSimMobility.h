@@ -20,6 +20,7 @@
 
 #include <omnetpp.h>
 #include "LineSegmentsMobilityBase.h"
+#include "ANSimTraceCache.h"
 
 
 /**
@@ -36,9 +37,12 @@ class INET_API ANSimMobility : public LineSegmentsMobilityBase
     int nodeId; ///< we'll have to compare this to the \<node_id> elements
 
     // state
-    cXMLElement *nextPosChange; ///< points to the next \<position_change> element
+    const ANSimTrace::WaypointList *waypoints; ///< our \<position_change> elements, from ANSimTraceCache
+    unsigned int nextWaypoint;                 ///< index into waypoints
 
   protected:
+    virtual ~ANSimMobility();
+
     /** @brief Initializes mobility model parameters.*/
     virtual void initialize(int);
 
@@ -46,11 +50,11 @@ class INET_API ANSimMobility : public LineSegmentsMobilityBase
     /** @brief Overridden from LineSegmentsMobilityBase.*/
     virtual void setTargetPosition();
 
-    /** @brief Utility: extract data from given \<position_update> element*/
-    virtual void extractDataFrom(cXMLElement *node);
-
     /** @brief Overridden from LineSegmentsMobilityBase.*/
     virtual void fixIfHostGetsOutside();
+
+    /** @brief The playground is convex, so checking waypoints is enough: positions may be trajectory-based */
+    virtual bool supportsTrajectory() {return true;}
 };
 
 #endif
@@ -0,0 +1,105 @@
+//
+// Copyright (C) 2009 Andras Varga
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ANSimTraceCache.h"
+
+
+static cXMLElement *firstChildWithTag(cXMLElement *node, const char *tagname)
+{
+    cXMLElement *child = node->getFirstChild();
+    while (child && strcmp(child->getTagName(), tagname)!=0)
+        child = child->getNextSibling();
+    if (!child)
+        opp_error("element <%s> has no <%s> child at %s", node->getTagName(), tagname, node->getSourceLocation());
+    return child;
+}
+
+
+ANSimTrace::WaypointList ANSimTrace::emptyList;
+
+const ANSimTrace::WaypointList& ANSimTrace::getWaypoints(int nodeId) const
+{
+    NodeMap::const_iterator it = nodes.find(nodeId);
+    return it==nodes.end() ? emptyList : it->second;
+}
+
+
+ANSimTraceCache *ANSimTraceCache::inst;
+
+ANSimTraceCache *ANSimTraceCache::getInstance()
+{
+    if (!inst)
+        inst = new ANSimTraceCache;
+    return inst;
+}
+
+void ANSimTraceCache::deleteInstance()
+{
+    if (inst)
+    {
+        delete inst;
+        inst = NULL;
+    }
+}
+
+const ANSimTrace *ANSimTraceCache::getTrace(cXMLElement *rootElem)
+{
+    // if found, return it from cache
+    TraceMap::iterator it = cache.find(rootElem);
+    if (it!=cache.end())
+        return &(it->second);
+
+    // parse and store in cache
+    ANSimTrace& trace = cache[rootElem];
+    parseTrace(rootElem, trace);
+    return &trace;
+}
+
+void ANSimTraceCache::parseTrace(cXMLElement *rootElem, ANSimTrace& trace)
+{
+    if (strcmp(rootElem->getTagName(),"simulation")!=0)
+        opp_error("ansimTrace: <simulation> is expected as root element not <%s> at %s",
+                  rootElem->getTagName(), rootElem->getSourceLocation());
+    cXMLElement *posChange = rootElem->getElementByPath("mobility/position_change");
+    if (!posChange)
+        opp_error("element doesn't have <mobility> child or <position_change> grandchild at %s",
+                  rootElem->getSourceLocation());
+
+    // single pass: append every <position_change> to its node's waypoint list
+    for (; posChange; posChange = posChange->getNextSibling())
+    {
+        const char *nodeIdStr = firstChildWithTag(posChange, "node_id")->getNodeValue();
+        if (!nodeIdStr)
+            continue;
+
+        // FIXME start_time has to be taken into account too! as pause from prev element's end_time
+        const char *endTimeStr = firstChildWithTag(posChange, "end_time")->getNodeValue();
+        cXMLElement *destElem = firstChildWithTag(posChange, "destination");
+        const char *xStr = firstChildWithTag(destElem, "xpos")->getNodeValue();
+        const char *yStr = firstChildWithTag(destElem, "ypos")->getNodeValue();
+
+        if (!endTimeStr || !xStr || !yStr)
+            opp_error("no content in <end_time>, <destination>/<xpos> or <ypos> element at %s", posChange->getSourceLocation());
+
+        ANSimTrace::Waypoint wp;
+        wp.endTime = atof(endTimeStr);
+        wp.x = atof(xStr);
+        wp.y = atof(yStr);
+        trace.nodes[atoi(nodeIdStr)].push_back(wp);
+    }
+}
+
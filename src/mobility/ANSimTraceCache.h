@@ -0,0 +1,91 @@
+//
+// Copyright (C) 2009 Andras Varga
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef ANSIMTRACECACHE_H
+#define ANSIMTRACECACHE_H
+
+#include <map>
+#include <vector>
+#include <omnetpp.h>
+#include "INETDefs.h"
+
+
+/**
+ * The \<position_change> elements of an ANSim trace file, pre-parsed
+ * and indexed by node id.
+ * @see ANSimTraceCache, ANSimMobility
+ */
+class INET_API ANSimTrace
+{
+  public:
+    /** Destination and arrival time of a \<position_change> element */
+    struct Waypoint
+    {
+        double endTime;
+        double x;
+        double y;
+    };
+    typedef std::vector<Waypoint> WaypointList;
+
+  protected:
+    friend class ANSimTraceCache;
+    typedef std::map<int,WaypointList> NodeMap;
+    NodeMap nodes;
+    static WaypointList emptyList;
+
+  public:
+    /** Returns the waypoints of the given node in trace order (empty list if none) */
+    const WaypointList& getWaypoints(int nodeId) const;
+};
+
+
+/**
+ * Singleton object to parse and store ANSim traces. Used within
+ * ANSimMobility. Needed because otherwise every node would have to
+ * walk the whole trace, skipping the elements of other nodes.
+ *
+ * @ingroup mobility
+ */
+class INET_API ANSimTraceCache
+{
+  protected:
+    typedef std::map<cXMLElement *,ANSimTrace> TraceMap;
+    TraceMap cache;
+    static ANSimTraceCache *inst;
+    void parseTrace(cXMLElement *rootElem, ANSimTrace& trace);
+    ANSimTraceCache() {}
+    virtual ~ANSimTraceCache() {}
+
+  public:
+    /**
+     * Returns the singleton instance.
+     */
+    static ANSimTraceCache *getInstance();
+
+    /**
+     * Deletes the singleton instance.
+     */
+    static void deleteInstance();
+
+    /**
+     * Returns the trace under the given \<simulation> element.
+     */
+    virtual const ANSimTrace *getTrace(cXMLElement *rootElem);
+};
+
+#endif
+
@@ -49,6 +49,7 @@ void BasicMobility::initialize(int stage)
         // get a pointer to the host
         hostPtr = findHost();
         myHostRef = cc->registerHost(hostPtr, Coord());
+        trajectoryBased = false;
     }
     else if (stage == 1)
     {
@@ -96,7 +97,11 @@ void BasicMobility::handleMessage(cMessage * msg)
 void BasicMobility::updatePosition()
 {
     cc->updateHostPosition(myHostRef, pos);
+    positionUpdated(true);
+}
 
+void BasicMobility::positionUpdated(bool notify)
+{
     if (ev.isGUI())
     {
         double r = cc->getCommunicationRange(myHostRef);
@@ -104,7 +109,44 @@ void BasicMobility::updatePosition()
         hostPtr->getDisplayString().setTagArg("p", 1, (long) pos.y);
         hostPtr->getDisplayString().setTagArg("r", 0, (long) r);
     }
-    nb->fireChangeNotification(NF_HOSTPOSITION_UPDATED, &pos);
+    if (notify)
+        nb->fireChangeNotification(NF_HOSTPOSITION_UPDATED, &pos);
+}
+
+double BasicMobility::getUpdateInterval()
+{
+    double interval = cc->getMobilityUpdateInterval();
+    return interval > 0 ? interval : par("updateInterval").doubleValue();
+}
+
+void BasicMobility::startPeriodicMove(double updateInterval, cMessage *msg)
+{
+    if (cc->getMobilityUpdateInterval() > 0)
+    {
+        // ChannelControl moves all hosts in one event
+        delete msg;
+        cc->registerMobility(myHostRef, this);
+    }
+    else
+    {
+        // host moves the first time after some random delay to avoid synchronized movements
+        scheduleAt(simTime() + uniform(0, updateInterval), msg);
+    }
+}
+
+void BasicMobility::beginSegment(const Coord& velocity)
+{
+    segmentStartTime = simTime();
+    this->velocity = velocity;
+    cc->registerTrajectory(myHostRef, this);
+    updatePosition();
+}
+
+bool BasicMobility::periodicMove()
+{
+    error("%s does not support centralized mobility updates (ChannelControl's "
+          "mobilityUpdateInterval parameter)", getClassName());
+    return false;
 }
 
 
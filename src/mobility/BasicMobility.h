@@ -73,6 +73,13 @@ class INET_API BasicMobility : public BasicModule
     /** @brief Stores the actual position of the host*/
     Coord pos;
 
+    /** @brief If true, pos is only the start of the current trajectory segment, see beginSegment() */
+    bool trajectoryBased;
+
+    /** @brief Start time and velocity of the current trajectory segment */
+    simtime_t segmentStartTime;
+    Coord velocity;
+
   protected:
     /** @brief This modules should only receive self-messages*/
     virtual void handleMessage(cMessage *msg);
@@ -97,6 +104,32 @@ class INET_API BasicMobility : public BasicModule
      */
     virtual void updatePosition();
 
+    /** @brief Returns the interval of periodic position updates.
+     *
+     * This is the interval of ChannelControl's centralized mobility updates
+     * if those are enabled, and the "updateInterval" parameter otherwise.
+     */
+    virtual double getUpdateInterval();
+
+    /** @brief Starts periodic position updates.
+     *
+     * Schedules msg after a random delay within updateInterval, to avoid
+     * synchronized movements. If ChannelControl performs centralized
+     * mobility updates, registers with it and deletes msg instead; then
+     * periodicMove() gets called at every update instead of handleSelfMsg().
+     */
+    virtual void startPeriodicMove(double updateInterval, cMessage *msg);
+
+    /** @brief Begins a new trajectory segment at pos, with the given velocity (m/s).
+     *
+     * For mobility models that set trajectoryBased (if ChannelControl is
+     * configured for trajectory-based positions): instead of periodic
+     * updates, they call this at waypoint changes, and ChannelControl
+     * computes the exact position via getPositionAt() when it is needed.
+     * Also calls updatePosition().
+     */
+    virtual void beginSegment(const Coord& velocity);
+
     /** @brief Returns the width of the playground */
     virtual double getPlaygroundSizeX() const  {return cc->getPgs()->x;}
 
@@ -140,6 +173,32 @@ class INET_API BasicMobility : public BasicModule
      */
     virtual void handleIfOutside(BorderPolicy policy, Coord& targetPos, Coord& step, double& angle);
 
+  public:
+    /** @brief Returns the current position of the host */
+    const Coord& getPosition() const {return pos;}
+
+    /** @brief Returns the position at time t on the current trajectory segment, see beginSegment() */
+    virtual Coord getPositionAt(simtime_t t) {return pos + velocity * SIMTIME_DBL(t - segmentStartTime);}
+
+    /** @brief Returns the speed (m/s) on the current trajectory segment, see beginSegment() */
+    virtual double getSegmentSpeed() {return velocity.distance(Coord(0,0));}
+
+    /** @brief Moves the host by one update interval.
+     *
+     * Called by ChannelControl if centralized mobility updates are enabled
+     * (see startPeriodicMove()), then positionUpdated(). Mobility models with
+     * periodic updates should redefine it; it should not call updatePosition().
+     * Returns false if the host will not move any more.
+     */
+    virtual bool periodicMove();
+
+    /** @brief Updates the display and optionally fires NF_HOSTPOSITION_UPDATED.
+     *
+     * updatePosition() calls it after ChannelControl has been informed; with
+     * centralized mobility updates ChannelControl calls it, and only fires
+     * the notification if the host's neighbor set changed.
+     */
+    virtual void positionUpdated(bool notify);
 };
 
 #endif
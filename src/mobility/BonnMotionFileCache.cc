@@ -15,16 +15,79 @@
 // along with this program; if not, see <http://www.gnu.org/licenses/>.
 //
 
-#include <fstream>
-#include <sstream>
+#include <stdio.h>
+#include <errno.h>
 #include "BonnMotionFileCache.h"
 
 
 const BonnMotionFile::Line *BonnMotionFile::getLine(int nodeId) const
 {
-    LineList::const_iterator it = lines.begin();
-    for (int i=0; i<nodeId && it!=lines.end(); i++) it++;
-    return (it==lines.end()) ? NULL : &(*it);
+    return (nodeId<0 || nodeId>=(int)lines.size()) ? NULL : &lines[nodeId];
+}
+
+
+/**
+ * Parses a decimal number starting at s, without going through the
+ * locale machinery of strtod() or iostreams. Numbers that cannot be
+ * converted exactly this way (too many digits, large exponents) are
+ * handed over to strtod(), so results are the same as with it.
+ * Returns false if there is no number at s.
+ */
+static bool parseDouble(const char *s, const char *end, double& value, const char *&next)
+{
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char *p = s;
+    bool negative = false;
+    if (p<end && (*p=='-' || *p=='+'))
+        negative = (*p++=='-');
+
+    uint64 mantissa = 0;
+    int numDigits = 0, exponent = 0;
+    bool anyDigits = false;
+    for (; p<end && *p>='0' && *p<='9'; p++, anyDigits = true)
+        if (mantissa || *p!='0')
+            {mantissa = 10*mantissa + (*p-'0'); numDigits++;}
+    if (p<end && *p=='.')
+        for (p++; p<end && *p>='0' && *p<='9'; p++, anyDigits = true)
+            if (mantissa || *p!='0')
+                {mantissa = 10*mantissa + (*p-'0'); numDigits++; exponent--;}
+            else
+                exponent--;
+    if (!anyDigits)
+        return false;
+    if (p<end && (*p=='e' || *p=='E'))
+    {
+        const char *q = p+1;
+        bool negativeExp = false;
+        if (q<end && (*q=='-' || *q=='+'))
+            negativeExp = (*q++=='-');
+        if (q<end && *q>='0' && *q<='9')
+        {
+            int e = 0;
+            for (; q<end && *q>='0' && *q<='9'; q++)
+                e = e<10000 ? 10*e + (*q-'0') : e;
+            exponent += negativeExp ? -e : e;
+            p = q;
+        }
+    }
+
+    if (numDigits<=15 && exponent>=-22 && exponent<=22)
+    {
+        // both operands are exact, so the result is correctly rounded
+        double d = (double)(int64)mantissa;
+        d = exponent<0 ? d / pow10[-exponent] : d * pow10[exponent];
+        value = negative ? -d : d;
+    }
+    else
+    {
+        // rare; strtod() needs a terminated string
+        std::string token(s, p-s);
+        value = strtod(token.c_str(), NULL);
+    }
+    next = p;
+    return true;
 }
 
 
@@ -61,23 +124,50 @@ const BonnMotionFile *BonnMotionFileCache::getFile(const char *filename)
 
 void BonnMotionFileCache::parseFile(const char *filename, BonnMotionFile& bmFile)
 {
-    std::ifstream in(filename, std::ios::in);
-    if (in.fail())
+    // read the whole file in one go
+    FILE *f = fopen(filename, "rb");
+    if (!f)
         opp_error("Cannot open file '%s'",filename);
+    std::vector<char> buffer;
+    char chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+        buffer.insert(buffer.end(), chunk, chunk+n);
+    bool failed = ferror(f);
+    fclose(f);
+    if (failed)
+        opp_error("Cannot read file '%s': %s", filename, strerror(errno));
 
-    std::string line;
-    while (std::getline(in, line))
+    // parse all numbers into one array, remembering where lines start;
+    // like reading with operator>>, a line ends at the first non-number
+    std::vector<size_t> lineStarts;
+    const char *p = buffer.empty() ? NULL : &buffer[0];
+    const char *end = p + buffer.size();
+    while (p<end)
     {
-        bmFile.lines.push_back(BonnMotionFile::Line());
-        BonnMotionFile::Line& vec = bmFile.lines.back();
+        lineStarts.push_back(bmFile.values.size());
+        const char *eol = (const char *)memchr(p, '\n', end-p);
+        if (!eol)
+            eol = end;
+        while (true)
+        {
+            while (p<eol && (*p==' ' || *p=='\t' || *p=='\r'))
+                p++;
+            double d;
+            if (p==eol || !parseDouble(p, eol, d, p))
+                break;
+            bmFile.values.push_back(d);
+        }
+        p = eol + 1;
+    }
 
-        std::stringstream linestream(line);
-        double d;
-        while (linestream >> d)
-            vec.push_back(d);
+    // values no longer changes, so lines can point into it
+    bmFile.lines.resize(lineStarts.size());
+    for (size_t i=0; i<lineStarts.size(); i++)
+    {
+        size_t lineEnd = i+1<lineStarts.size() ? lineStarts[i+1] : bmFile.values.size();
+        bmFile.lines[i].values = bmFile.values.empty() ? NULL : &bmFile.values[0] + lineStarts[i];
+        bmFile.lines[i].numValues = lineEnd - lineStarts[i];
     }
-    in.close();
 }
 
-
-
@@ -18,7 +18,6 @@
 #ifndef BONNMOTIONFILECACHE_H
 #define BONNMOTIONFILECACHE_H
 
-#include <list>
 #include <vector>
 #include <omnetpp.h>
 #include "BasicMobility.h"
@@ -26,17 +25,28 @@
 class BonnMotionFileCache;
 
 /**
- * Represents a BonnMotion file's contents.
+ * Represents a BonnMotion file's contents. All numbers of the file are
+ * stored in one contiguous array, and lines are indexed by node id.
  * @see BonnMotionFileCache, BonnMotionMobility
  */
 class INET_API BonnMotionFile
 {
   public:
-    typedef std::vector<double> Line;
+    /** The numbers on one line of the file */
+    class Line
+    {
+      protected:
+        friend class BonnMotionFileCache;
+        const double *values;
+        int numValues;
+      public:
+        int size() const {return numValues;}
+        double operator[](int i) const {return values[i];}
+    };
   protected:
     friend class BonnMotionFileCache;
-    typedef std::list<Line> LineList;
-    LineList lines;
+    std::vector<double> values;
+    std::vector<Line> lines;
   public:
     const Line *getLine(int nodeId) const;
 };
@@ -29,7 +29,11 @@ void BonnMotionMobility::initialize(int stage)
 
     EV << "initializing BonnMotionMobility stage " << stage << endl;
 
-    if (stage == 1)
+    if (stage == 0)
+    {
+        keepTraceCache = par("keepTraceCache");
+    }
+    else if (stage == 1)
     {
         int nodeId = par("nodeId");
         if (nodeId == -1)
@@ -57,7 +61,8 @@ void BonnMotionMobility::initialize(int stage)
 
 BonnMotionMobility::~BonnMotionMobility()
 {
-    BonnMotionFileCache::deleteInstance();
+    if (!keepTraceCache)
+        BonnMotionFileCache::deleteInstance();
 }
 
 void BonnMotionMobility::setTargetPosition()
@@ -35,6 +35,10 @@ class INET_API BonnMotionMobility : public LineSegmentsMobilityBase
     // state
     const BonnMotionFile::Line *vecp;
     int vecpos;
+    bool keepTraceCache;
+
+  public:
+    BonnMotionMobility() {keepTraceCache = false;}
 
   protected:
     virtual ~BonnMotionMobility();
@@ -47,6 +51,9 @@ class INET_API BonnMotionMobility : public LineSegmentsMobilityBase
 
     /** @brief Overridden from LineSegmentsMobilityBase.*/
     virtual void fixIfHostGetsOutside();
+
+    /** @brief The playground is convex, so checking waypoints is enough: positions may be trajectory-based */
+    virtual bool supportsTrajectory() {return true;}
 };
 
 #endif
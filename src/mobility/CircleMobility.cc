@@ -36,21 +36,27 @@ void CircleMobility::initialize(int stage)
         r = par("r");
         ASSERT(r>0);
         angle = par("startAngle").doubleValue()/180.0*PI;
-        updateInterval = par("updateInterval");
+        updateInterval = getUpdateInterval();
         double speed = par("speed");
         omega = speed/r;
 
         // calculate initial position
         pos.x = cx + r * cos(angle);
         pos.y = cy + r * sin(angle);
-        updatePosition();
 
         // if the initial speed is lower than 0, the node is stationary
         stationary = (speed == 0);
 
-        // host moves the first time after some random delay to avoid synchronized movements
-        if (!stationary)
-            scheduleAt(simTime() + uniform(0, updateInterval), new cMessage("move"));
+        // with trajectory-based positions, no events are needed at all
+        trajectoryBased = cc->isTrajectoryBased();
+
+        if (trajectoryBased)
+            beginSegment(Coord(0,0));
+        else
+            updatePosition();
+
+        if (!stationary && !trajectoryBased)
+            startPeriodicMove(updateInterval, new cMessage("move"));
     }
 }
 
@@ -62,6 +68,18 @@ void CircleMobility::handleSelfMsg(cMessage * msg)
     scheduleAt(simTime() + updateInterval, msg);
 }
 
+Coord CircleMobility::getPositionAt(simtime_t t)
+{
+    double a = angle + omega * SIMTIME_DBL(t - segmentStartTime);
+    return Coord(cx + r * cos(a), cy + r * sin(a));
+}
+
+bool CircleMobility::periodicMove()
+{
+    move();
+    return true;
+}
+
 void CircleMobility::move()
 {
     angle += omega * updateInterval;
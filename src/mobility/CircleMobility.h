@@ -52,6 +52,16 @@ class INET_API CircleMobility : public BasicMobility
 
     /** @brief Move the host*/
     virtual void move();
+
+  public:
+    /** @brief Called by ChannelControl with centralized mobility updates */
+    virtual bool periodicMove();
+
+    /** @brief The whole circle is one trajectory segment */
+    virtual Coord getPositionAt(simtime_t t);
+
+    /** @brief The speed along the circle */
+    virtual double getSegmentSpeed() {return fabs(omega * r);}
 };
 
 #endif
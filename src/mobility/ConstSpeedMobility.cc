@@ -40,20 +40,27 @@ void ConstSpeedMobility::initialize(int stage)
 
     if (stage == 0)
     {
-        updateInterval = par("updateInterval");
+        updateInterval = getUpdateInterval();
         vHost = par("vHost");
 
         // if the initial speed is lower than 0, the node is stationary
         stationary = (vHost <= 0);
 
+        // with trajectory-based positions, events are only needed at the targets
+        trajectoryBased = cc->isTrajectoryBased();
+
         //calculate the target position of the host if the host moves
-        if (!stationary)
+        if (!stationary && !trajectoryBased)
         {
             setTargetPosition();
-            //host moves the first time after some random delay to avoid synchronized movements
-            scheduleAt(simTime() + uniform(0, updateInterval), new cMessage("move"));
+            startPeriodicMove(updateInterval, new cMessage("move"));
         }
     }
+    else if (stage == 1)
+    {
+        if (!stationary && trajectoryBased)
+            beginSegmentToTarget(new cMessage("move"));
+    }
 }
 
 
@@ -63,11 +70,35 @@ void ConstSpeedMobility::initialize(int stage)
  */
 void ConstSpeedMobility::handleSelfMsg(cMessage * msg)
 {
+    if (trajectoryBased)
+    {
+        pos = targetPos;
+        beginSegmentToTarget(msg);
+        return;
+    }
+
     move();
     updatePosition();
     scheduleAt(simTime() + updateInterval, msg);
 }
 
+void ConstSpeedMobility::beginSegmentToTarget(cMessage *msg)
+{
+    targetPos = getRandomPosition();
+    double totalTime = pos.distance(targetPos) / vHost;
+
+    EV << "xpos= " << targetPos.x << " ypos=" << targetPos.y << " totalTime=" << totalTime << endl;
+
+    beginSegment(totalTime > 0 ? (targetPos - pos) / totalTime : Coord(0,0));
+    scheduleAt(simTime() + totalTime, msg);
+}
+
+bool ConstSpeedMobility::periodicMove()
+{
+    move();
+    return true;
+}
+
 
 /**
  * Calculate a new random position and the number of steps the host
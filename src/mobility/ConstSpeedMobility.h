@@ -70,6 +70,13 @@ class INET_API ConstSpeedMobility : public BasicMobility
 
     /** @brief Move the host*/
     virtual void move();
+
+    /** @brief With trajectory-based positions: choose a target and begin a segment towards it */
+    virtual void beginSegmentToTarget(cMessage *msg);
+
+  public:
+    /** @brief Called by ChannelControl with centralized mobility updates */
+    virtual bool periodicMove();
 };
 
 #endif
@@ -26,13 +26,23 @@ void LineSegmentsMobilityBase::initialize(int stage)
 
     if (stage == 1)
     {
-        updateInterval = par("updateInterval");
         stationary = false;
         targetPos = pos;
         targetTime = simTime();
 
-        // host moves the first time after some random delay to avoid synchronized movements
-        scheduleAt(simTime() + uniform(0, updateInterval), new cMessage("move"));
+        trajectoryBased = cc->isTrajectoryBased() && supportsTrajectory();
+        if (trajectoryBased)
+        {
+            // events only at the end of line segments; the first one
+            // is chosen when all initialization is done
+            updateInterval = 0;
+            scheduleAt(simTime(), new cMessage("move"));
+        }
+        else
+        {
+            updateInterval = getUpdateInterval();
+            startPeriodicMove(updateInterval, new cMessage("move"));
+        }
     }
 }
 
@@ -48,6 +58,26 @@ void LineSegmentsMobilityBase::beginNextMove(cMessage *msg)
     if (targetTime<now)
         error("LineSegmentsMobilityBase: targetTime<now was set in %s's beginNextMove()", getClassName());
 
+    if (trajectoryBased)
+    {
+        // fixIfHostGetsOutside() can only check waypoints here, see supportsTrajectory()
+        fixIfHostGetsOutside();
+        step.x = step.y = 0;
+        if (stationary)
+        {
+            beginSegment(Coord(0,0));
+            delete msg;
+        }
+        else
+        {
+            double duration = SIMTIME_DBL(targetTime - now);
+            beginSegment(duration > 0 ? (targetPos - pos) / duration : Coord(0,0));
+            scheduleAt(targetTime, msg);
+        }
+        return;
+    }
+
+    // msg is NULL with centralized mobility updates (see periodicMove())
     if (stationary)
     {
         // end of movement
@@ -58,7 +88,8 @@ void LineSegmentsMobilityBase::beginNextMove(cMessage *msg)
     {
         // no movement, just wait
         step.x = step.y = 0;
-        scheduleAt(std::max(targetTime,simTime()), msg);
+        if (msg)
+            scheduleAt(std::max(targetTime,simTime()), msg);
     }
     else
     {
@@ -72,12 +103,19 @@ void LineSegmentsMobilityBase::beginNextMove(cMessage *msg)
         //        = (targetPos-pos) / (targetTime-now) * updateInterval =
         //        = (targetPos-pos) / numIntervals
         step = (targetPos - pos) / numIntervals;
-        scheduleAt(simTime() + updateInterval, msg);
+        if (msg)
+            scheduleAt(simTime() + updateInterval, msg);
     }
 }
 
 void LineSegmentsMobilityBase::handleSelfMsg(cMessage *msg)
 {
+    if (trajectoryBased)
+    {
+        beginNextMove(msg);
+        return;
+    }
+
     if (stationary)
     {
         delete msg;
@@ -103,4 +141,16 @@ void LineSegmentsMobilityBase::handleSelfMsg(cMessage *msg)
     updatePosition();
 }
 
+bool LineSegmentsMobilityBase::periodicMove()
+{
+    if (stationary)
+        return false;
+    if (simTime()+updateInterval >= targetTime)
+        beginNextMove(NULL);
+
+    pos += step;
+    fixIfHostGetsOutside();
+    return !stationary;
+}
+
 
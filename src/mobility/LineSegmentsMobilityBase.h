@@ -51,7 +51,7 @@ class INET_API LineSegmentsMobilityBase : public BasicMobility
     /** @brief Called upon arrival of a self messages*/
     virtual void handleSelfMsg(cMessage *msg);
 
-    /** @brief Begin new line segment after previous one finished */
+    /** @brief Begin new line segment after previous one finished; msg may be NULL */
     virtual void beginNextMove(cMessage *msg);
 
     /**
@@ -67,6 +67,17 @@ class INET_API LineSegmentsMobilityBase : public BasicMobility
      * or directly one of the methods it relies on.
      */
     virtual void fixIfHostGetsOutside() = 0;
+
+    /**
+     * @brief Should return true if the model can be used with trajectory-based
+     * positions (see BasicMobility::beginSegment()); fixIfHostGetsOutside()
+     * is then only invoked at waypoints, so it must not alter the movement.
+     */
+    virtual bool supportsTrajectory() {return false;}
+
+  public:
+    /** @brief Called by ChannelControl with centralized mobility updates */
+    virtual bool periodicMove();
 };
 
 #endif
@@ -16,6 +16,7 @@
 // along with this program; if not, see <http://www.gnu.org/licenses/>.
 //
 
+#include <algorithm>   // min
 #include "LinearMobility.h"
 #include "FWMath.h"
 
@@ -31,7 +32,7 @@ void LinearMobility::initialize(int stage)
 
     if (stage == 0)
     {
-        updateInterval = par("updateInterval");
+        updateInterval = getUpdateInterval();
         speed = par("speed");
         angle = par("angle");
         acceleration = par("acceleration");
@@ -40,9 +41,17 @@ void LinearMobility::initialize(int stage)
         // if the initial speed is lower than 0, the node is stationary
         stationary = (speed == 0);
 
-        // host moves the first time after some random delay to avoid synchronized movements
-        if (!stationary)
-            scheduleAt(simTime() + uniform(0, updateInterval), new cMessage("move"));
+        // with trajectory-based positions, events are only needed when the
+        // host hits a wall; not possible with acceleration
+        trajectoryBased = cc->isTrajectoryBased() && acceleration == 0;
+
+        if (!stationary && !trajectoryBased)
+            startPeriodicMove(updateInterval, new cMessage("move"));
+    }
+    else if (stage == 1)
+    {
+        if (!stationary && trajectoryBased)
+            beginLinearSegment(new cMessage("move"));
     }
 }
 
@@ -53,12 +62,53 @@ void LinearMobility::initialize(int stage)
  */
 void LinearMobility::handleSelfMsg(cMessage * msg)
 {
+    if (trajectoryBased)
+    {
+        // reflect off the wall
+        pos = wallPos;
+        if (hitsWallX)
+            angle = 180 - angle;
+        if (hitsWallY)
+            angle = -angle;
+        beginLinearSegment(msg);
+        return;
+    }
+
     move();
     updatePosition();
     if (!stationary)
         scheduleAt(simTime() + updateInterval, msg);
 }
 
+void LinearMobility::beginLinearSegment(cMessage *msg)
+{
+    Coord v(speed * cos(PI * angle / 180), speed * sin(PI * angle / 180));
+
+    // time until the host hits the walls in x and y direction (-1: never)
+    double tx = v.x > 0 ? (getPlaygroundSizeX() - pos.x) / v.x : v.x < 0 ? -pos.x / v.x : -1;
+    double ty = v.y > 0 ? (getPlaygroundSizeY() - pos.y) / v.y : v.y < 0 ? -pos.y / v.y : -1;
+    double t = tx < 0 ? ty : ty < 0 ? tx : std::min(tx, ty);
+
+    hitsWallX = tx >= 0 && tx <= t;
+    hitsWallY = ty >= 0 && ty <= t;
+    wallPos = pos + v * t;
+    if (hitsWallX)
+        wallPos.x = v.x > 0 ? getPlaygroundSizeX() : 0;
+    if (hitsWallY)
+        wallPos.y = v.y > 0 ? getPlaygroundSizeY() : 0;
+
+    EV << " xpos= " << pos.x << " ypos=" << pos.y << " speed=" << speed << ", next wall in " << t << "s" << endl;
+
+    beginSegment(v);
+    scheduleAt(simTime() + t, msg);
+}
+
+bool LinearMobility::periodicMove()
+{
+    move();
+    return !stationary;
+}
+
 /**
  * Move the host if the destination is not reached yet. Otherwise
  * calculate a new random position
@@ -38,6 +38,11 @@ class INET_API LinearMobility : public BasicMobility
     double updateInterval; ///< time interval to update the hosts position
     bool stationary;       ///< if true, the host doesn't move
 
+    // with trajectory-based positions: end of the current segment
+    Coord wallPos;         ///< where the host hits the wall
+    bool hitsWallX;        ///< whether it hits a vertical wall there
+    bool hitsWallY;        ///< whether it hits a horizontal wall there
+
   protected:
     /** @brief Initializes mobility model parameters.*/
     virtual void initialize(int);
@@ -48,6 +53,13 @@ class INET_API LinearMobility : public BasicMobility
 
     /** @brief Move the host*/
     virtual void move();
+
+    /** @brief With trajectory-based positions: begin a segment that lasts until the next wall */
+    virtual void beginLinearSegment(cMessage *msg);
+
+  public:
+    /** @brief Called by ChannelControl with centralized mobility updates */
+    virtual bool periodicMove();
 };
 
 #endif
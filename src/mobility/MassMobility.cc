@@ -42,7 +42,7 @@ void MassMobility::initialize(int stage)
 
     if (stage == 0)
     {
-        updateInterval = par("updateInterval");
+        updateInterval = getUpdateInterval();
 
         changeInterval = &par("changeInterval");
         changeAngleBy = &par("changeAngleBy");
@@ -54,7 +54,7 @@ void MassMobility::initialize(int stage)
         step.x = currentSpeed * cos(PI * currentAngle / 180) * updateInterval;
         step.y = currentSpeed * sin(PI * currentAngle / 180) * updateInterval;
 
-        scheduleAt(simTime() + uniform(0, updateInterval), new cMessage("move", MK_UPDATE_POS));
+        startPeriodicMove(updateInterval, new cMessage("move", MK_UPDATE_POS));
         scheduleAt(simTime() + uniform(0, changeInterval->doubleValue()), new cMessage("turn", MK_CHANGE_DIR));
     }
 }
@@ -86,6 +86,12 @@ void MassMobility::handleSelfMsg(cMessage * msg)
 
 }
 
+bool MassMobility::periodicMove()
+{
+    move();
+    return true;
+}
+
 /**
  * Move the host if the destination is not reached yet. Otherwise
  * calculate a new random position
@@ -57,6 +57,10 @@ class INET_API MassMobility : public BasicMobility
 
     /** @brief Move the host*/
     virtual void move();
+
+  public:
+    /** @brief Called by ChannelControl with centralized mobility updates */
+    virtual bool periodicMove();
 };
 
 #endif
@@ -42,6 +42,9 @@ class INET_API RandomWPMobility : public LineSegmentsMobilityBase
 
     /** @brief Overridden from LineSegmentsMobilityBase.*/
     virtual void fixIfHostGetsOutside();
+
+    /** @brief The playground is convex, so checking waypoints is enough: positions may be trajectory-based */
+    virtual bool supportsTrajectory() {return true;}
 };
 
 #endif
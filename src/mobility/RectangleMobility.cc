@@ -39,7 +39,7 @@ void RectangleMobility::initialize(int stage)
         y1 = par("y1");
         x2 = par("x2");
         y2 = par("y2");
-        updateInterval = par("updateInterval");
+        updateInterval = getUpdateInterval();
         speed = par("speed");
 
         // if the initial speed is lower than 0, the node is stationary
@@ -68,9 +68,8 @@ void RectangleMobility::initialize(int stage)
         WATCH(d);
         updatePosition();
 
-        // host moves the first time after some random delay to avoid synchronized movements
         if (!stationary)
-            scheduleAt(simTime() + uniform(0, updateInterval), new cMessage("move"));
+            startPeriodicMove(updateInterval, new cMessage("move"));
     }
 }
 
@@ -86,6 +85,12 @@ void RectangleMobility::handleSelfMsg(cMessage * msg)
     scheduleAt(simTime() + updateInterval, msg);
 }
 
+bool RectangleMobility::periodicMove()
+{
+    move();
+    return true;
+}
+
 void RectangleMobility::move()
 {
     d += speed * updateInterval;
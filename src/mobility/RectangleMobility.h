@@ -53,6 +53,10 @@ class INET_API RectangleMobility : public BasicMobility
 
     /** @brief Maps d to (x,y) coordinates */
     virtual void calculateXY();
+
+  public:
+    /** @brief Called by ChannelControl with centralized mobility updates */
+    virtual bool periodicMove();
 };
 
 #endif
@@ -30,12 +30,92 @@ static std::ostream& operator<< (std::ostream& out, cMessage *msg)
 static std::ostream& operator<< (std::ostream& out, const ARP::ARPCacheEntry& e)
 {
     if (e.pending)
-        out << "pending (" << e.numRetries << " retries)";
+        out << "pending (" << e.pending->numRetries << " retries, " << e.pending->packets.length() << " packets)";
     else
         out << "MAC:" << e.macAddress << "  age:" << floor(simTime()-e.lastUpdate) << "s";
     return out;
 }
 
+static std::ostream& operator<< (std::ostream& out, const ARP::ARPCache& cache)
+{
+    out << cache.size() << " entries";
+    for (int k=0; k<cache.getNumSlots(); k++)
+        if (!cache.getSlot(k).ipAddress.isUnspecified())
+            out << "; " << cache.getSlot(k).ipAddress << ": " << cache.getSlot(k);
+    return out;
+}
+
+
+ARP::ARPCache::ARPCache()
+{
+    slots.resize(16);
+    numEntries = 0;
+}
+
+ARP::ARPCacheEntry *ARP::ARPCache::find(const IPAddress& addr)
+{
+    int mask = slots.size()-1;
+    for (int k=slotFor(addr); ; k=(k+1)&mask)
+    {
+        if (slots[k].ipAddress==addr)
+            return &slots[k];
+        if (slots[k].ipAddress.isUnspecified())
+            return NULL;
+    }
+}
+
+ARP::ARPCacheEntry *ARP::ARPCache::insert(const IPAddress& addr)
+{
+    ASSERT(!addr.isUnspecified() && find(addr)==NULL);
+    if (2*(numEntries+1) > (int)slots.size())
+        grow();
+
+    int mask = slots.size()-1;
+    int k = slotFor(addr);
+    while (!slots[k].ipAddress.isUnspecified())
+        k = (k+1)&mask;
+    slots[k].ipAddress = addr;
+    numEntries++;
+    return &slots[k];
+}
+
+void ARP::ARPCache::grow()
+{
+    std::vector<ARPCacheEntry> oldSlots(2*slots.size());
+    oldSlots.swap(slots);
+    numEntries = 0;
+    for (int k=0; k<(int)oldSlots.size(); k++)
+        if (!oldSlots[k].ipAddress.isUnspecified())
+            *insert(oldSlots[k].ipAddress) = oldSlots[k];
+}
+
+void ARP::ARPCache::erase(const IPAddress& addr)
+{
+    ARPCacheEntry *entry = find(addr);
+    ASSERT(entry!=NULL);
+
+    // backward-shift deletion: move up following entries of the probe
+    // sequence which would otherwise become unreachable
+    int mask = slots.size()-1;
+    int hole = entry - &slots[0];
+    for (int k=(hole+1)&mask; !slots[k].ipAddress.isUnspecified(); k=(k+1)&mask)
+    {
+        int home = slotFor(slots[k].ipAddress);
+        bool reachable = (hole<=k) ? (hole<home && home<=k) : (hole<home || home<=k);
+        if (!reachable)
+        {
+            slots[hole] = slots[k];
+            hole = k;
+        }
+    }
+    slots[hole] = ARPCacheEntry();
+    numEntries--;
+}
+
+
+ARP::GlobalARPTable ARP::globalARPTable;
+bool ARP::globalARPTableBuilt = false;
+int ARP::numInstances = 0;
 
 Define_Module (ARP);
 
@@ -50,18 +130,20 @@ void ARP::initialize()
     retryCount = par("retryCount");
     cacheTimeout = par("cacheTimeout");
     doProxyARP = par("proxyARP");
-
-    pendingQueue.setName("pendingQueue");
+    globalARP = par("globalARP");
+    maxPendingPackets = par("maxPendingPackets");
 
     // init statistics
     numRequestsSent = numRepliesSent = 0;
     numResolutions = numFailedResolutions = 0;
+    numDroppedPendingPackets = 0;
     WATCH(numRequestsSent);
     WATCH(numRepliesSent);
     WATCH(numResolutions);
     WATCH(numFailedResolutions);
+    WATCH(numDroppedPendingPackets);
 
-    WATCH_PTRMAP(arpCache);
+    WATCH(arpCache);
 }
 
 void ARP::finish()
@@ -70,15 +152,25 @@ void ARP::finish()
     recordScalar("ARP replies sent", numRepliesSent);
     recordScalar("ARP resolutions", numResolutions);
     recordScalar("failed ARP resolutions", numFailedResolutions);
+    recordScalar("ARP dropped pending packets", numDroppedPendingPackets);
 }
 
 ARP::~ARP()
 {
-    while (!arpCache.empty())
+    for (int k=0; k<arpCache.getNumSlots(); k++)
+    {
+        PendingResolution *pending = arpCache.getSlot(k).pending;
+        if (pending)
+        {
+            cancelAndDelete(pending->timer);
+            delete pending;
+        }
+    }
+
+    if (--numInstances==0)
     {
-        ARPCache::iterator i = arpCache.begin();
-        delete (*i).second;
-        arpCache.erase(i);
+        globalARPTable.clear();
+        globalARPTableBuilt = false;
     }
 }
 
@@ -129,7 +221,8 @@ void ARP::processOutboundPacket(cMessage *msg)
     }
 
     // determine what address to look up in ARP cache
-    if (!nextHopAddr.isUnspecified())
+    bool isProxyARP = nextHopAddr.isUnspecified();
+    if (!isProxyARP)
     {
         EV << "using next-hop address " << nextHopAddr << "\n";
     }
@@ -174,63 +267,88 @@ void ARP::processOutboundPacket(cMessage *msg)
 #endif
     }
 
+    // in globalARP mode, resolve directly from the interface tables of the network.
+    // With proxy ARP we don't know which router would answer, so that case
+    // (and addresses not found in the table) goes through the protocol.
+    if (globalARP && !isProxyARP)
+    {
+        MACAddress macAddress;
+        if (lookupGlobalARPTable(nextHopAddr, macAddress))
+        {
+            EV << "global ARP: MAC address for " << nextHopAddr << " is " << macAddress << ", sending packet down\n";
+            sendPacketToNIC(msg, ie, macAddress);
+            return;
+        }
+        EV << "global ARP: " << nextHopAddr << " not found or ambiguous, using ARP protocol\n";
+    }
+
     // try look up
-    ARPCache::iterator it = arpCache.find(nextHopAddr);
-    //ASSERT(it==arpCache.end() || ie==(*it).second->ie); // verify: if arpCache gets keyed on InterfaceEntry* too, this becomes unnecessary
-    if (it==arpCache.end())
+    ARPCacheEntry *entry = arpCache.find(nextHopAddr);
+    //ASSERT(entry==NULL || ie==entry->ie); // verify: if arpCache gets keyed on InterfaceEntry* too, this becomes unnecessary
+    if (!entry)
     {
         // no cache entry: launch ARP request
-        ARPCacheEntry *entry = new ARPCacheEntry();
-        ARPCache::iterator where = arpCache.insert(arpCache.begin(), std::make_pair(nextHopAddr,entry));
-        entry->myIter = where; // note: "inserting a new element into a map does not invalidate iterators that point to existing elements"
+        entry = arpCache.insert(nextHopAddr);
         entry->ie = ie;
 
         EV << "Starting ARP resolution for " << nextHopAddr << "\n";
         initiateARPResolution(entry);
 
         // and queue up packet
-        entry->pendingPackets.push_back(msg);
-        pendingQueue.insert(msg);
+        queuePendingPacket(entry, msg);
     }
-    else if ((*it).second->pending)
+    else if (entry->pending)
     {
         // an ARP request is already pending for this address -- just queue up packet
         EV << "ARP resolution for " << nextHopAddr << " is pending, queueing up packet\n";
-        (*it).second->pendingPackets.push_back(msg);
-        pendingQueue.insert(msg);
+        queuePendingPacket(entry, msg);
     }
-    else if ((*it).second->lastUpdate+cacheTimeout<simTime())
+    else if (entry->lastUpdate+cacheTimeout<simTime())
     {
         EV << "ARP cache entry for " << nextHopAddr << " expired, starting new ARP resolution\n";
 
         // cache entry stale, send new ARP request
-        ARPCacheEntry *entry = (*it).second;
         entry->ie = ie; // routing table may have changed
         initiateARPResolution(entry);
 
         // and queue up packet
-        entry->pendingPackets.push_back(msg);
-        pendingQueue.insert(msg);
+        queuePendingPacket(entry, msg);
     }
     else
     {
         // valid ARP cache entry found, flag msg with MAC address and send it out
-        EV << "ARP cache hit, MAC address for " << nextHopAddr << " is " << (*it).second->macAddress << ", sending packet down\n";
-        sendPacketToNIC(msg, ie, (*it).second->macAddress);
+        EV << "ARP cache hit, MAC address for " << nextHopAddr << " is " << entry->macAddress << ", sending packet down\n";
+        sendPacketToNIC(msg, ie, entry->macAddress);
     }
 }
 
+void ARP::queuePendingPacket(ARPCacheEntry *entry, cMessage *msg)
+{
+    cQueue& packets = entry->pending->packets;
+    if (maxPendingPackets>=0 && packets.length()>=maxPendingPackets)
+    {
+        EV << "Too many packets (" << packets.length() << ") waiting for ARP resolution of "
+           << entry->ipAddress << ", dropping packet\n";
+        numDroppedPendingPackets++;
+        delete msg;
+        return;
+    }
+    packets.insert(msg);
+}
+
 void ARP::initiateARPResolution(ARPCacheEntry *entry)
 {
-    IPAddress nextHopAddr = entry->myIter->first;
-    entry->pending = true;
-    entry->numRetries = 0;
+    IPAddress nextHopAddr = entry->ipAddress;
+    PendingResolution *pending = entry->pending = new PendingResolution();
+    pending->ipAddress = nextHopAddr;
+    pending->numRetries = 0;
+    pending->packets.setName("pendingPackets");
     entry->lastUpdate = 0;
     sendARPRequest(entry->ie, nextHopAddr);
 
     // start timer
-    cMessage *msg = entry->timer = new cMessage("ARP timeout");
-    msg->setContextPointer(entry);
+    cMessage *msg = pending->timer = new cMessage("ARP timeout");
+    msg->setContextPointer(pending);
     scheduleAt(simTime()+retryTimeout, msg);
 
     numResolutions++;
@@ -272,35 +390,28 @@ void ARP::sendARPRequest(InterfaceEntry *ie, IPAddress ipAddress)
 
 void ARP::requestTimedOut(cMessage *selfmsg)
 {
-    ARPCacheEntry *entry = (ARPCacheEntry *)selfmsg->getContextPointer();
-    entry->numRetries++;
-    if (entry->numRetries < retryCount)
+    PendingResolution *pending = (PendingResolution *)selfmsg->getContextPointer();
+    ARPCacheEntry *entry = arpCache.find(pending->ipAddress);
+    ASSERT(entry && entry->pending==pending);
+    pending->numRetries++;
+    if (pending->numRetries < retryCount)
     {
         // retry
-        IPAddress nextHopAddr = entry->myIter->first;
-        EV << "ARP request for " << nextHopAddr << " timed out, resending\n";
-        sendARPRequest(entry->ie, nextHopAddr);
+        EV << "ARP request for " << pending->ipAddress << " timed out, resending\n";
+        sendARPRequest(entry->ie, pending->ipAddress);
         scheduleAt(simTime()+retryTimeout, selfmsg);
         return;
     }
 
     // max retry count reached: ARP failure.
     // throw out entry from cache, delete pending messages
-    MsgPtrVector& pendingPackets = entry->pendingPackets;
     EV << "ARP timeout, max retry count " << retryCount << " for "
-       << entry->myIter->first << " reached. Dropping " << pendingPackets.size()
+       << pending->ipAddress << " reached. Dropping " << pending->packets.length()
        << " waiting packets from the queue\n";
-    while (!pendingPackets.empty())
-    {
-        MsgPtrVector::iterator i = pendingPackets.begin();
-        cMessage *msg = (*i);
-        pendingPackets.erase(i);
-        pendingQueue.remove(msg);
-        delete msg;
-    }
+    pending->packets.clear();
     delete selfmsg;
-    arpCache.erase(entry->myIter);
-    delete entry;
+    arpCache.erase(pending->ipAddress);
+    delete pending;
     numFailedResolutions++;
 }
 
@@ -374,11 +485,10 @@ void ARP::processARPPacket(ARPPacket *arp)
 
     bool mergeFlag = false;
     // "If ... sender protocol address is already in my translation table"
-    ARPCache::iterator it = arpCache.find(srcIPAddress);
-    if (it!=arpCache.end())
+    ARPCacheEntry *entry = arpCache.find(srcIPAddress);
+    if (entry)
     {
         // "update the sender hardware address field"
-        ARPCacheEntry *entry = (*it).second;
         updateARPCache(entry, srcMACAddress);
         mergeFlag = true;
     }
@@ -391,22 +501,8 @@ void ARP::processARPPacket(ARPPacket *arp)
         // protocol address, sender hardware address to the translation table"
         if (!mergeFlag)
         {
-            ARPCacheEntry *entry;
-            if (it!=arpCache.end())
-            {
-                entry = (*it).second;
-            }
-            else
-            {
-                entry = new ARPCacheEntry();
-                ARPCache::iterator where = arpCache.insert(arpCache.begin(), std::make_pair(srcIPAddress,entry));
-                entry->myIter = where;
-                entry->ie = ie;
-
-                entry->pending = false;
-                entry->timer = NULL;
-                entry->numRetries = 0;
-            }
+            entry = arpCache.insert(srcIPAddress);
+            entry->ie = ie;
             updateARPCache(entry, srcMACAddress);
         }
 
@@ -455,30 +551,68 @@ void ARP::processARPPacket(ARPPacket *arp)
 
 void ARP::updateARPCache(ARPCacheEntry *entry, const MACAddress& macAddress)
 {
-    EV << "Updating ARP cache entry: " << entry->myIter->first << " <--> " << macAddress << "\n";
+    EV << "Updating ARP cache entry: " << entry->ipAddress << " <--> " << macAddress << "\n";
 
     // update entry
-    if (entry->pending)
-    {
-        entry->pending = false;
-        delete cancelEvent(entry->timer);
-        entry->timer = NULL;
-        entry->numRetries = 0;
-    }
+    PendingResolution *pending = entry->pending;
+    entry->pending = NULL;
     entry->macAddress = macAddress;
     entry->lastUpdate = simTime();
 
     // process queued packets
-    MsgPtrVector& pendingPackets = entry->pendingPackets;
-    while (!pendingPackets.empty())
+    if (pending)
+    {
+        delete cancelEvent(pending->timer);
+        while (!pending->packets.empty())
+        {
+            cMessage *msg = (cMessage *)pending->packets.pop();
+            EV << "Sending out queued packet " << msg << "\n";
+            sendPacketToNIC(msg, entry->ie, macAddress);
+        }
+        delete pending;
+    }
+}
+
+void ARP::buildGlobalARPTable()
+{
+    // collect the addresses of all interfaces in the network. Addresses that
+    // occur on more than one interface (e.g. routers configured by
+    // FlatNetworkConfigurator) are stored with an unspecified MAC address,
+    // because we cannot tell which interface is on the given link.
+    globalARPTable.clear();
+    for (int id=0; id<=simulation.getLastModuleId(); id++)
     {
-        MsgPtrVector::iterator i = pendingPackets.begin();
-        cMessage *msg = (*i);
-        pendingPackets.erase(i);
-        pendingQueue.remove(msg);
-        EV << "Sending out queued packet " << msg << "\n";
-        sendPacketToNIC(msg, entry->ie, macAddress);
+        IInterfaceTable *ift = dynamic_cast<IInterfaceTable *>(simulation.getModule(id));
+        if (!ift)
+            continue;
+        for (int k=0; k<ift->getNumInterfaces(); k++)
+        {
+            InterfaceEntry *ie = ift->getInterface(k);
+            if (!ie->ipv4Data() || ie->getMacAddress().isUnspecified())
+                continue;
+            IPAddress addr = ie->ipv4Data()->getIPAddress();
+            if (addr.isUnspecified())
+                continue;
+            GlobalARPTable::iterator it = globalARPTable.find(addr.getInt());
+            if (it==globalARPTable.end())
+                globalARPTable[addr.getInt()] = ie->getMacAddress();
+            else if (it->second!=ie->getMacAddress())
+                it->second = MACAddress::UNSPECIFIED_ADDRESS;
+        }
     }
+    globalARPTableBuilt = true;
 }
 
+bool ARP::lookupGlobalARPTable(const IPAddress& addr, MACAddress& macAddress)
+{
+    // addresses are final by the time the first packet is sent
+    if (!globalARPTableBuilt)
+        buildGlobalARPTable();
+
+    GlobalARPTable::iterator it = globalARPTable.find(addr.getInt());
+    if (it==globalARPTable.end() || it->second.isUnspecified())
+        return false;
+    macAddress = it->second;
+    return true;
+}
 
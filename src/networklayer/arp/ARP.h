@@ -21,8 +21,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <vector>
-#include <map>
 #include <omnetpp.h>
+#include "HashMap.h"
 #include "IPAddress.h"
 #include "ARPPacket_m.h"
 #include "IPControlInfo.h"
@@ -40,46 +40,84 @@
 class INET_API ARP : public cSimpleModule
 {
   public:
-    struct ARPCacheEntry;
-    typedef std::map<IPAddress, ARPCacheEntry*> ARPCache;
-    typedef std::vector<cMessage*> MsgPtrVector;
+    // state of an ongoing address resolution
+    struct PendingResolution
+    {
+        IPAddress ipAddress; // the address being resolved
+        int numRetries;      // 0 after first ARP request, 1 after second, etc.
+        cMessage *timer;     // request timeout msg
+        cQueue packets;      // packets waiting for resolution (at most maxPendingPackets)
+    };
 
     // IPAddress -> MACAddress table
     // TBD should we key it on (IPAddress, InterfaceEntry*)?
     struct ARPCacheEntry
     {
+        IPAddress ipAddress;  // key; unspecified if the slot is free
         InterfaceEntry *ie; // NIC to send the packet to
-        bool pending; // true if resolution is pending
         MACAddress macAddress;  // MAC address
         simtime_t lastUpdate;  // entries should time out after cacheTimeout
-        int numRetries; // if pending==true: 0 after first ARP request, 1 after second, etc.
-        cMessage *timer;  // if pending==true: request timeout msg
-        MsgPtrVector pendingPackets;  // if pending==true: ptrs to packets waiting for resolution
-                                      // (packets are owned by pendingQueue)
-        ARPCache::iterator myIter;  // iterator pointing to this entry
+        PendingResolution *pending; // non-NULL if resolution is pending
+
+        ARPCacheEntry() {ie = NULL; pending = NULL;}
     };
 
+    /**
+     * The ARP cache: an open-addressing hash table (linear probing) with
+     * the entries stored inline. Note that insert() may relocate entries,
+     * so ARPCacheEntry pointers must not be kept across insertions.
+     */
+    class ARPCache
+    {
+      protected:
+        std::vector<ARPCacheEntry> slots;  // size is a power of two, at most half full
+        int numEntries;
+
+        int slotFor(const IPAddress& addr) const {return inet_hashInt(addr.getInt()) & (slots.size()-1);}
+        void grow();
+
+      public:
+        ARPCache();
+        ARPCacheEntry *find(const IPAddress& addr);
+        ARPCacheEntry *insert(const IPAddress& addr);
+        void erase(const IPAddress& addr);
+        int size() const {return numEntries;}
+        int getNumSlots() const {return slots.size();}
+        const ARPCacheEntry& getSlot(int k) const {return slots[k];}
+    };
+
+    // IP address -> MAC address map for the whole network, used in globalARP mode
+    typedef inet_hash::unordered_map<uint32,MACAddress> GlobalARPTable;
+
   protected:
     simtime_t retryTimeout;
     int retryCount;
     simtime_t cacheTimeout;
     bool doProxyARP;
+    bool globalARP;
+    int maxPendingPackets;
 
     long numResolutions;
     long numFailedResolutions;
     long numRequestsSent;
     long numRepliesSent;
+    long numDroppedPendingPackets;
 
     ARPCache arpCache;
 
-    cQueue pendingQueue; // outbound packets waiting for ARP resolution
     int nicOutBaseGateId;  // id of the nicOut[0] gate
 
     IInterfaceTable *ift;
     IRoutingTable *rt;  // for Proxy ARP
 
+    // shared among all ARP modules in globalARP mode; built on first use,
+    // and released when the last ARP module is deleted
+    static GlobalARPTable globalARPTable;
+    static bool globalARPTableBuilt;
+    static int numInstances;
+
   public:
-    ARP() {}
+    ARP() {numInstances++;}
     virtual ~ARP();
 
   protected:
@@ -89,6 +127,7 @@ class INET_API ARP : public cSimpleModule
 
     virtual void processOutboundPacket(cMessage *msg);
     virtual void sendPacketToNIC(cMessage *msg, InterfaceEntry *ie, const MACAddress& macAddress);
+    virtual void queuePendingPacket(ARPCacheEntry *entry, cMessage *msg);
 
     virtual void initiateARPResolution(ARPCacheEntry *entry);
     virtual void sendARPRequest(InterfaceEntry *ie, IPAddress ipAddress);
@@ -97,6 +136,10 @@ class INET_API ARP : public cSimpleModule
     virtual void processARPPacket(ARPPacket *arp);
     virtual void updateARPCache(ARPCacheEntry *entry, const MACAddress& macAddress);
 
+    // globalARP mode
+    virtual void buildGlobalARPTable();
+    virtual bool lookupGlobalARPTable(const IPAddress& addr, MACAddress& macAddress);
+
     virtual void dumpARPPacket(ARPPacket *arp);
     virtual void updateDisplayString();
 
@@ -16,6 +16,8 @@
 //
 
 #include <algorithm>
+#include <deque>
+#include <map>
 #include "IRoutingTable.h"
 #include "IInterfaceTable.h"
 #include "IPAddressResolver.h"
@@ -27,9 +29,34 @@
 Define_Module(FlatNetworkConfigurator);
 
 
+static int countNonLoopbackInterfaces(IInterfaceTable *ift)
+{
+    int numIntf = 0;
+    for (int k=0; k<ift->getNumInterfaces(); k++)
+        if (!ift->getInterface(k)->isLoopback())
+            numIntf++;
+    return numIntf;
+}
+
+
+FlatNetworkConfigurator::~FlatNetworkConfigurator()
+{
+    for (unsigned int i=0; i<reports.size(); i++)
+        delete reports[i];
+}
+
 void FlatNetworkConfigurator::initialize(int stage)
 {
-    if (stage==2)
+    if (stage==2 && gateSize("peer")>0)
+    {
+        // parallel simulation: we only see the nodes of our own partition,
+        // so we exchange topology with the configurators of the other
+        // partitions first, and configure when all reports have arrived
+        if (par("hierarchical").boolValue())
+            error("hierarchical=true is not supported if the configurator has peers");
+        sendReports();
+    }
+    else if (stage==2)
     {
         cTopology topo("topo");
         NodeInfoVector nodeInfo; // will be of size topo.nodes[]
@@ -38,15 +65,23 @@ void FlatNetworkConfigurator::initialize(int stage)
         // isIPNode, rt and ift members of nodeInfo[]
         extractTopology(topo, nodeInfo);
 
+        bool hierarchical = par("hierarchical").boolValue();
+
         // assign addresses to IP nodes, and also store result in nodeInfo[].address
-        assignAddresses(topo, nodeInfo);
+        if (hierarchical)
+            assignHierarchicalAddresses(topo, nodeInfo);
+        else
+            assignAddresses(topo, nodeInfo);
 
         // add default routes to hosts (nodes with a single attachment);
         // also remember result in nodeInfo[].usesDefaultRoute
         addDefaultRoutes(topo, nodeInfo);
 
         // calculate shortest paths, and add corresponding static routes
-        fillRoutingTables(topo, nodeInfo);
+        if (hierarchical)
+            fillAggregatedRoutingTables(topo, nodeInfo);
+        else
+            fillRoutingTables(topo, nodeInfo);
 
         // update display string
         setDisplayString(topo, nodeInfo);
@@ -64,6 +99,16 @@ void FlatNetworkConfigurator::extractTopology(cTopology& topo, NodeInfoVector& n
     for (int i=0; i<topo.getNumNodes(); i++)
     {
         cModule *mod = topo.getNode(i)->getModule();
+        if (mod->isPlaceholder())
+        {
+            // in another partition of a parallel simulation: its configurator
+            // will tell us about it, see sendReports()
+            if (gateSize("peer")==0)
+                error("%s is in another partition: with parallel simulation, there must be a configurator "
+                      "in every partition, connected to each other via their peer gates", mod->getFullPath().c_str());
+            nodeInfo[i].isLocal = false;
+            continue;
+        }
         nodeInfo[i].isIPNode = IPAddressResolver().findInterfaceTableOf(mod)!=NULL;
         if (nodeInfo[i].isIPNode)
         {
@@ -92,6 +137,10 @@ void FlatNetworkConfigurator::assignAddresses(cTopology& topo, NodeInfoVector& n
         uint32 addr = networkAddress | uint32(++numIPNodes);
         nodeInfo[i].address.set(addr);
 
+        // nodes in other partitions are configured by their own configurator
+        if (!nodeInfo[i].isLocal)
+            continue;
+
         // find interface table and assign address to all (non-loopback) interfaces
         IInterfaceTable *ift = nodeInfo[i].ift;
         for (int k=0; k<ift->getNumInterfaces(); k++)
@@ -113,8 +162,8 @@ void FlatNetworkConfigurator::addDefaultRoutes(cTopology& topo, NodeInfoVector&
     {
         cTopology::Node *node = topo.getNode(i);
 
-        // skip bus types
-        if (!nodeInfo[i].isIPNode)
+        // skip bus types, and nodes in other partitions
+        if (!nodeInfo[i].isIPNode || !nodeInfo[i].isLocal)
             continue;
 
         IInterfaceTable *ift = nodeInfo[i].ift;
@@ -203,21 +252,420 @@ void FlatNetworkConfigurator::fillRoutingTables(cTopology& topo, NodeInfoVector&
     }
 }
 
+void FlatNetworkConfigurator::assignHierarchicalAddresses(cTopology& topo, NodeInfoVector& nodeInfo)
+{
+    // Every router (IP node with more than one non-loopback interface) owns
+    // an address block; hosts join the block of the nearest router, looking
+    // through non-IP nodes such as Ethernet switches. Unreachable hosts get
+    // a block of their own.
+    int numNodes = topo.getNumNodes();
+    std::map<cTopology::Node *, int> nodeIndex;
+    for (int i=0; i<numNodes; i++)
+        nodeIndex[topo.getNode(i)] = i;
+
+    std::deque<int> queue;
+    for (int i=0; i<numNodes; i++)
+    {
+        nodeInfo[i].owner = -1;
+        nodeInfo[i].ownerGateId = -1;
+        if (nodeInfo[i].isIPNode && countNonLoopbackInterfaces(nodeInfo[i].ift)>1)
+        {
+            nodeInfo[i].owner = i;
+            queue.push_back(i);
+        }
+    }
+
+    // multi-source breadth-first search from all routers at once
+    while (!queue.empty())
+    {
+        int k = queue.front();
+        queue.pop_front();
+
+        cTopology::Node *node = topo.getNode(k);
+        for (int j=0; j<node->getNumOutLinks(); j++)
+        {
+            int m = nodeIndex[node->getLinkOut(j)->getRemoteNode()];
+            if (nodeInfo[m].owner!=-1)
+                continue;
+            nodeInfo[m].owner = nodeInfo[k].owner;
+            nodeInfo[m].ownerGateId = (nodeInfo[k].owner==k) ? node->getLinkOut(j)->getLocalGate()->getId() : nodeInfo[k].ownerGateId;
+            if (!nodeInfo[m].isIPNode)
+                queue.push_back(m);  // only non-IP nodes are transparent
+        }
+    }
+
+    // count blocks and the size of the largest one (owner included)
+    std::vector<int> blockSize(numNodes, 0);
+    int numBlocks = 0;
+    int maxBlockSize = 0;
+    for (int i=0; i<numNodes; i++)
+    {
+        if (!nodeInfo[i].isIPNode)
+            continue;
+        if (nodeInfo[i].owner==-1)
+            nodeInfo[i].owner = i;
+        if (nodeInfo[i].owner==i)
+            numBlocks++;
+        maxBlockSize = std::max(maxBlockSize, ++blockSize[nodeInfo[i].owner]);
+    }
+
+    // host part of a block must leave room for the all-zeros and all-ones addresses
+    int hostBits = 1;
+    while ((1<<hostBits) < maxBlockSize+2)
+        hostBits++;
+
+    uint32 networkAddress = IPAddress(par("networkAddress").stringValue()).getInt();
+    uint32 netmask = IPAddress(par("netmask").stringValue()).getInt();
+    if (((uint64)numBlocks << hostBits) > (uint64)(~netmask)+1)
+        error("netmask too large, not enough addresses for %d blocks of %d addresses each", numBlocks, 1<<hostBits);
+    blockNetmask.set(~((uint32(1) << hostBits)-1));
+
+    EV << "hierarchical addressing: " << numBlocks << " address blocks, netmask " << blockNetmask << "\n";
+
+    // number blocks in node order, and hand out addresses within them
+    std::vector<uint32> blockPrefix(numNodes, 0);
+    std::vector<uint32> nextHostId(numNodes, 2);
+    int blockCtr = 0;
+    for (int i=0; i<numNodes; i++)
+        if (nodeInfo[i].isIPNode && nodeInfo[i].owner==i)
+            blockPrefix[i] = networkAddress | (uint32(blockCtr++) << hostBits);
+
+    for (int i=0; i<numNodes; i++)
+    {
+        // skip bus types
+        if (!nodeInfo[i].isIPNode)
+            continue;
+
+        int owner = nodeInfo[i].owner;
+        uint32 addr = blockPrefix[owner] | (owner==i ? 1 : nextHostId[owner]++);
+        nodeInfo[i].address.set(addr);
+
+        // assign address to all (non-loopback) interfaces
+        IInterfaceTable *ift = nodeInfo[i].ift;
+        for (int k=0; k<ift->getNumInterfaces(); k++)
+        {
+            InterfaceEntry *ie = ift->getInterface(k);
+            if (!ie->isLoopback())
+            {
+                ie->ipv4Data()->setIPAddress(IPAddress(addr));
+                ie->ipv4Data()->setNetmask(IPAddress::ALLONES_ADDRESS); // full address must match for local delivery
+            }
+        }
+    }
+}
+
+void FlatNetworkConfigurator::fillAggregatedRoutingTables(cTopology& topo, NodeInfoVector& nodeInfo)
+{
+    // Each router gets host routes to the members of its own block, and one
+    // prefix route per other block. Hosts already have their default route.
+    int numNodes = topo.getNumNodes();
+    std::map<cTopology::Node *, int> nodeIndex;
+    for (int i=0; i<numNodes; i++)
+        nodeIndex[topo.getNode(i)] = i;
+
+    for (int i=0; i<numNodes; i++)
+    {
+        if (!nodeInfo[i].isIPNode || nodeInfo[i].owner!=i)
+            continue;
+
+        // host routes towards the members of our own block
+        if (!nodeInfo[i].usesDefaultRoute)
+        {
+            for (int m=0; m<numNodes; m++)
+            {
+                if (m==i || !nodeInfo[m].isIPNode || nodeInfo[m].owner!=i)
+                    continue;
+
+                InterfaceEntry *ie = nodeInfo[i].ift->getInterfaceByNodeOutputGateId(nodeInfo[m].ownerGateId);
+                if (!ie)
+                    error("%s has no interface for output gate id %d", nodeInfo[i].ift->getFullPath().c_str(), nodeInfo[m].ownerGateId);
+
+                IPRoute *e = new IPRoute();
+                e->setHost(nodeInfo[m].address);
+                e->setNetmask(IPAddress::ALLONES_ADDRESS); // full match needed
+                e->setInterface(ie);
+                e->setType(IPRoute::DIRECT);
+                e->setSource(IPRoute::MANUAL);
+                nodeInfo[i].rt->addRoute(e);
+            }
+        }
+
+        IPAddress destPrefix = nodeInfo[i].address.doAnd(blockNetmask);
+        cTopology::Node *destNode = topo.getNode(i);
+        std::string destModName = destNode->getModule()->getFullName();
+
+        // calculate shortest paths from everywhere towards the block owner
+        topo.calculateUnweightedSingleShortestPathsTo(destNode);
+
+        // add one aggregated route to every other router
+        for (int j=0; j<numNodes; j++)
+        {
+            if (i==j) continue;
+            if (!nodeInfo[j].isIPNode || nodeInfo[j].owner!=j)
+                continue;
+
+            cTopology::Node *atNode = topo.getNode(j);
+            if (atNode->getNumPaths()==0)
+                continue; // not connected
+            if (nodeInfo[j].usesDefaultRoute)
+                continue; // already added default route here
+
+            IInterfaceTable *ift = nodeInfo[j].ift;
+            int outputGateId = atNode->getPath(0)->getLocalGate()->getId();
+            InterfaceEntry *ie = ift->getInterfaceByNodeOutputGateId(outputGateId);
+            if (!ie)
+                error("%s has no interface for output gate id %d", ift->getFullPath().c_str(), outputGateId);
+
+            // next hop is the first IP node along the path
+            cTopology::Node *nextHop = atNode->getPath(0)->getRemoteNode();
+            while (!nodeInfo[nodeIndex[nextHop]].isIPNode)
+                nextHop = nextHop->getPath(0)->getRemoteNode();
+            IPAddress gateway = nodeInfo[nodeIndex[nextHop]].address;
+
+            EV << "  from " << atNode->getModule()->getFullName() << "=" << nodeInfo[j].address;
+            EV << " towards " << destModName << "'s block " << destPrefix << "/" << blockNetmask
+               << " via " << gateway << " interface " << ie->getName() << endl;
+
+            IPRoute *e = new IPRoute();
+            e->setHost(destPrefix);
+            e->setNetmask(blockNetmask);
+            e->setGateway(gateway);
+            e->setInterface(ie);
+            e->setType(IPRoute::REMOTE);
+            e->setSource(IPRoute::MANUAL);
+            nodeInfo[j].rt->addRoute(e);
+        }
+    }
+}
+
+void FlatNetworkConfigurator::extractLocalLinks(cTopology& topo, NodeInfoVector& nodeInfo, LinkInfoVector& links)
+{
+    // links leaving the nodes of our partition, in cTopology order
+    int numNodes = topo.getNumNodes();
+    std::map<cTopology::Node *, int> nodeIndex;
+    for (int i=0; i<numNodes; i++)
+        nodeIndex[topo.getNode(i)] = i;
+
+    for (int i=0; i<numNodes; i++)
+    {
+        if (!nodeInfo[i].isLocal)
+            continue;
+        cTopology::Node *node = topo.getNode(i);
+        for (int j=0; j<node->getNumOutLinks(); j++)
+        {
+            LinkInfo link;
+            link.src = i;
+            link.gateId = node->getLinkOut(j)->getLocalGate()->getId();
+            link.dest = nodeIndex[node->getLinkOut(j)->getRemoteNode()];
+            links.push_back(link);
+        }
+    }
+}
+
+void FlatNetworkConfigurator::sendReports()
+{
+    cTopology topo("topo");
+    NodeInfoVector nodeInfo;
+    extractTopology(topo, nodeInfo);
+    LinkInfoVector links;
+    extractLocalLinks(topo, nodeInfo, links);
+
+    int numNodes = topo.getNumNodes();
+    FlatNetworkConfiguratorReport *report = new FlatNetworkConfiguratorReport("topology");
+    report->setNodePathArraySize(numNodes);
+    report->setIsLocalArraySize(numNodes);
+    report->setIsIPNodeArraySize(numNodes);
+    for (int i=0; i<numNodes; i++)
+    {
+        report->setNodePath(i, topo.getNode(i)->getModule()->getFullPath().c_str());
+        report->setIsLocal(i, nodeInfo[i].isLocal);
+        report->setIsIPNode(i, nodeInfo[i].isIPNode);
+    }
+    report->setLinkSrcArraySize(links.size());
+    report->setLinkGateIdArraySize(links.size());
+    report->setLinkDestArraySize(links.size());
+    for (unsigned int k=0; k<links.size(); k++)
+    {
+        report->setLinkSrc(k, links[k].src);
+        report->setLinkGateId(k, links[k].gateId);
+        report->setLinkDest(k, links[k].dest);
+    }
+
+    EV << "sending topology report (" << links.size() << " links) to " << gateSize("peer") << " peer(s)\n";
+    for (int k=0; k<gateSize("peer"); k++)
+        send(k==gateSize("peer")-1 ? report : report->dup(), "peer$o", k);
+}
+
 void FlatNetworkConfigurator::handleMessage(cMessage *msg)
 {
-    error("this module doesn't handle messages, it runs only in initialize()");
+    if (gateSize("peer")==0)
+        error("this module doesn't handle messages, it runs only in initialize()");
+
+    reports.push_back(check_and_cast<FlatNetworkConfiguratorReport *>(msg));
+    if ((int)reports.size() == gateSize("peer"))
+    {
+        configureFromReports();
+        for (unsigned int i=0; i<reports.size(); i++)
+            delete reports[i];
+        reports.clear();
+    }
+}
+
+void FlatNetworkConfigurator::mergeReports(cTopology& topo, NodeInfoVector& nodeInfo, LinkInfoVector& links)
+{
+    // every node must be local in exactly one partition
+    int numNodes = topo.getNumNodes();
+    std::vector<bool> covered(numNodes);
+    for (int i=0; i<numNodes; i++)
+        covered[i] = nodeInfo[i].isLocal;
+
+    for (unsigned int r=0; r<reports.size(); r++)
+    {
+        FlatNetworkConfiguratorReport *report = reports[r];
+        int peer = report->getArrivalGate()->getIndex();
+        if ((int)report->getNodePathArraySize()!=numNodes)
+            error("topology report on peer[%d] lists %d nodes instead of %d", peer, report->getNodePathArraySize(), numNodes);
+        for (int i=0; i<numNodes; i++)
+        {
+            if (topo.getNode(i)->getModule()->getFullPath()!=report->getNodePath(i))
+                error("topology report on peer[%d]: node %d is %s instead of %s",
+                      peer, i, report->getNodePath(i), topo.getNode(i)->getModule()->getFullPath().c_str());
+            if (!report->getIsLocal(i))
+                continue;
+            if (covered[i])
+                error("%s is reported by the configurators of two partitions", report->getNodePath(i));
+            covered[i] = true;
+            nodeInfo[i].isIPNode = report->getIsIPNode(i);
+        }
+        for (unsigned int k=0; k<report->getLinkSrcArraySize(); k++)
+        {
+            LinkInfo link;
+            link.src = report->getLinkSrc(k);
+            link.gateId = report->getLinkGateId(k);
+            link.dest = report->getLinkDest(k);
+            links.push_back(link);
+        }
+    }
+
+    for (int i=0; i<numNodes; i++)
+        if (!covered[i])
+            error("%s is in a partition without a configurator", topo.getNode(i)->getModule()->getFullPath().c_str());
+}
+
+void FlatNetworkConfigurator::configureFromReports()
+{
+    EV << "all topology reports arrived, configuring the nodes of this partition\n";
+
+    cTopology topo("topo");
+    NodeInfoVector nodeInfo;
+    extractTopology(topo, nodeInfo);
+
+    LinkInfoVector links;
+    extractLocalLinks(topo, nodeInfo, links);
+    mergeReports(topo, nodeInfo, links);
+
+    // links of each node come from one partition, in cTopology order;
+    // order them by source node like the whole network's cTopology would
+    std::stable_sort(links.begin(), links.end());
+
+    // same steps as in initialize(), for the local nodes only
+    assignAddresses(topo, nodeInfo);
+    addDefaultRoutes(topo, nodeInfo);
+    fillRoutingTables(nodeInfo, links);
+    setDisplayString(topo, nodeInfo);
+}
+
+void FlatNetworkConfigurator::fillRoutingTables(NodeInfoVector& nodeInfo, const LinkInfoVector& links)
+{
+    // the network-wide topology is only available as a list of links here, so
+    // we cannot use cTopology. The search below follows the same order as
+    // cTopology::calculateUnweightedSingleShortestPathsTo() (in-links ordered
+    // by source node), so the same paths are chosen as in a sequential run.
+    int numNodes = nodeInfo.size();
+    std::vector<std::vector<const LinkInfo *> > inLinks(numNodes);
+    for (unsigned int k=0; k<links.size(); k++)
+        inLinks[links[k].dest].push_back(&links[k]);
+
+    for (int i=0; i<numNodes; i++)
+    {
+        // skip bus types
+        if (!nodeInfo[i].isIPNode)
+            continue;
+
+        IPAddress destAddr = nodeInfo[i].address;
+
+        // breadth-first search towards node i; outputGateId[j] is the first hop from j
+        std::vector<int> outputGateId(numNodes, -1);
+        std::vector<bool> reached(numNodes, false);
+        std::deque<int> queue;
+        reached[i] = true;
+        queue.push_back(i);
+        while (!queue.empty())
+        {
+            int v = queue.front();
+            queue.pop_front();
+            for (unsigned int k=0; k<inLinks[v].size(); k++)
+            {
+                int w = inLinks[v][k]->src;
+                if (!reached[w])
+                {
+                    reached[w] = true;
+                    outputGateId[w] = inLinks[v][k]->gateId;
+                    queue.push_back(w);
+                }
+            }
+        }
+
+        // add route (with host=destNode) to the routing tables of our partition
+        for (int j=0; j<numNodes; j++)
+        {
+            if (i==j) continue;
+            if (!nodeInfo[j].isIPNode || !nodeInfo[j].isLocal)
+                continue;
+            if (!reached[j])
+                continue; // not connected
+            if (nodeInfo[j].usesDefaultRoute)
+                continue; // already added default route here
+
+            IInterfaceTable *ift = nodeInfo[j].ift;
+            InterfaceEntry *ie = ift->getInterfaceByNodeOutputGateId(outputGateId[j]);
+            if (!ie)
+                error("%s has no interface for output gate id %d", ift->getFullPath().c_str(), outputGateId[j]);
+
+            EV << "  from " << nodeInfo[j].address << " towards " << destAddr << " interface " << ie->getName() << endl;
+
+            IPRoute *e = new IPRoute();
+            e->setHost(destAddr);
+            e->setNetmask(IPAddress(255,255,255,255)); // full match needed
+            e->setInterface(ie);
+            e->setType(IPRoute::DIRECT);
+            e->setSource(IPRoute::MANUAL);
+            nodeInfo[j].rt->addRoute(e);
+        }
+    }
 }
 
 void FlatNetworkConfigurator::setDisplayString(cTopology& topo, NodeInfoVector& nodeInfo)
 {
+    int numNodes = 0;
     int numIPNodes = 0;
+    int numRoutes = 0;
     for (int i=0; i<topo.getNumNodes(); i++)
+    {
+        if (!nodeInfo[i].isLocal)
+            continue; // in another partition
+        numNodes++;
         if (nodeInfo[i].isIPNode)
+        {
             numIPNodes++;
+            numRoutes += nodeInfo[i].rt->getNumRoutes();
+        }
+    }
+    EV << "total " << numRoutes << " routes in " << numIPNodes << " routing tables\n";
 
     // update display string
     char buf[80];
-    sprintf(buf, "%d IP nodes\n%d non-IP nodes", numIPNodes, topo.getNumNodes()-numIPNodes);
+    sprintf(buf, "%d IP nodes\n%d non-IP nodes\n%d routes", numIPNodes, numNodes-numIPNodes, numRoutes);
     getDisplayString().setTagArg("t",0,buf);
 }
 
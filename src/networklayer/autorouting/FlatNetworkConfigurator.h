@@ -21,6 +21,7 @@
 #include <omnetpp.h>
 #include "INETDefs.h"
 #include "IPAddress.h"
+#include "FlatNetworkConfiguratorReport_m.h"
 
 class IInterfaceTable;
 class IRoutingTable;
@@ -37,15 +38,36 @@ class INET_API FlatNetworkConfigurator : public cSimpleModule
 {
   protected:
     struct NodeInfo {
-        NodeInfo() {isIPNode=false;ift=NULL;rt=NULL;usesDefaultRoute=false;}
+        NodeInfo() {isLocal=true;isIPNode=false;ift=NULL;rt=NULL;usesDefaultRoute=false;owner=-1;ownerGateId=-1;}
+        bool isLocal;     // false if the node is in another partition of a parallel simulation
         bool isIPNode;
         IInterfaceTable *ift;
         IRoutingTable *rt;
         IPAddress address;
         bool usesDefaultRoute;
+        int owner;        // hierarchical mode: index of the node owning our address block
+        int ownerGateId;  // hierarchical mode: output gate id of the owner towards us
     };
     typedef std::vector<NodeInfo> NodeInfoVector;
 
+    // parallel simulation: a link between two nodes, by node index
+    struct LinkInfo {
+        int src;     // source node
+        int gateId;  // output gate id at the source node
+        int dest;    // destination node
+        bool operator<(const LinkInfo& other) const {return src < other.src;}
+    };
+    typedef std::vector<LinkInfo> LinkInfoVector;
+
+    IPAddress blockNetmask; // hierarchical mode: netmask of per-router address blocks
+
+    // parallel simulation: reports received from the configurators of the other partitions
+    std::vector<FlatNetworkConfiguratorReport *> reports;
+
+  public:
+    FlatNetworkConfigurator() {}
+    virtual ~FlatNetworkConfigurator();
+
   protected:
     virtual int numInitStages() const  {return 3;}
     virtual void initialize(int stage);
@@ -56,6 +78,16 @@ class INET_API FlatNetworkConfigurator : public cSimpleModule
     virtual void addDefaultRoutes(cTopology& topo, NodeInfoVector& nodeInfo);
     virtual void fillRoutingTables(cTopology& topo, NodeInfoVector& nodeInfo);
 
+    virtual void assignHierarchicalAddresses(cTopology& topo, NodeInfoVector& nodeInfo);
+    virtual void fillAggregatedRoutingTables(cTopology& topo, NodeInfoVector& nodeInfo);
+
+    // parallel simulation
+    virtual void extractLocalLinks(cTopology& topo, NodeInfoVector& nodeInfo, LinkInfoVector& links);
+    virtual void sendReports();
+    virtual void mergeReports(cTopology& topo, NodeInfoVector& nodeInfo, LinkInfoVector& links);
+    virtual void configureFromReports();
+    virtual void fillRoutingTables(NodeInfoVector& nodeInfo, const LinkInfoVector& links);
+
     virtual void setDisplayString(cTopology& topo, NodeInfoVector& nodeInfo);
 };
 
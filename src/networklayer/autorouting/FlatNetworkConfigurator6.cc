@@ -17,38 +17,77 @@
 //
 
 #include <algorithm>
+#include <set>
+#include <time.h>
 #include "FlatNetworkConfigurator6.h"
 #include "IInterfaceTable.h"
 #include "IPAddressResolver.h"
+#include "ModuleAccess.h"
 #ifndef WITHOUT_IPv6
 #include "IPv6InterfaceData.h"
 #include "RoutingTable6.h"
+#include "IPv6NeighbourDiscovery.h"
 #endif
 
 // FIXME UPDATE DOCU!!!!!!!
 
 Define_Module(FlatNetworkConfigurator6);
 
+static double secondsSince(clock_t start)
+{
+    return (clock() - start) / (double)CLOCKS_PER_SEC;
+}
+
 void FlatNetworkConfigurator6::initialize(int stage)
 {
 #ifndef WITHOUT_IPv6
     // FIXME refactor: make routers[] array? (std::vector<cTopology::Node*>)
     // FIXME: spare common beginning for all stages?
 
+    if (stage==0)
+    {
+        fastStart = par("fastStart");
+        prefixSetupTime = routeSetupTime = fastStartSetupTime = 0;
+    }
+    if (stage!=2 && stage!=3)
+        return;
+
     cTopology topo("topo");
 
     // extract topology
+    clock_t start = clock();
     topo.extractByProperty("node");
     EV << "cTopology found " << topo.getNumNodes() << " nodes\n";
 
     if (stage==2)
     {
         configureAdvPrefixes(topo);
+        prefixSetupTime += secondsSince(start);
+        EV << "advertised prefixes configured in " << prefixSetupTime << "s\n";
+
+        if (fastStart)
+        {
+            // must precede stage 3, where Neighbour Discovery would start its timers
+            start = clock();
+            disableAutoconfiguration(topo);
+            fastStartSetupTime += secondsSince(start);
+        }
     }
     else if (stage==3)
     {
         addOwnAdvPrefixRoutes(topo);
         addStaticRoutes(topo);
+        routeSetupTime += secondsSince(start);
+        EV << "routes configured in " << routeSetupTime << "s\n";
+
+        if (fastStart)
+        {
+            start = clock();
+            configureHostsFromAdvPrefixes(topo);
+            fillNeighbourCaches(topo);
+            fastStartSetupTime += secondsSince(start);
+            EV << "addresses, default routers and neighbour caches configured in " << fastStartSetupTime << "s\n";
+        }
     }
 #else
     error("FlatNetworkConfigurator6 not supported: WITHOUT_IPv6 option was defined during compilation");
@@ -60,6 +99,16 @@ void FlatNetworkConfigurator6::handleMessage(cMessage *)
     error("this module doesn't handle messages, it runs only in initialize()");
 }
 
+void FlatNetworkConfigurator6::finish()
+{
+#ifndef WITHOUT_IPv6
+    recordScalar("prefix setup CPU time", prefixSetupTime);
+    recordScalar("route setup CPU time", routeSetupTime);
+    if (fastStart)
+        recordScalar("fast start setup CPU time", fastStartSetupTime);
+#endif
+}
+
 void FlatNetworkConfigurator6::setDisplayString(int numIPNodes, int numNonIPNodes)
 {
     // update display string
@@ -70,7 +119,11 @@ void FlatNetworkConfigurator6::setDisplayString(int numIPNodes, int numNonIPNode
 
 bool FlatNetworkConfigurator6::isIPNode(cTopology::Node *node)
 {
-    return IPAddressResolver().findInterfaceTableOf(node->getModule()) != NULL;
+    cModule *mod = node->getModule();
+    if (mod->isPlaceholder())
+        error("%s is in another partition: the network configurator cannot be used with "
+              "a network split across partitions of a parallel simulation", mod->getFullPath().c_str());
+    return IPAddressResolver().findInterfaceTableOf(mod) != NULL;
 }
 
 #ifndef WITHOUT_IPv6
@@ -263,6 +316,191 @@ void FlatNetworkConfigurator6::addStaticRoutes(cTopology& topo)
     // update display string
     setDisplayString(numIPNodes, topo.getNumNodes()-numIPNodes);
 }
-#endif
+static IPv6NeighbourDiscovery *neighbourDiscoveryOf(cModule *host)
+{
+    cModule *mod = findModuleWhereverInNode("neighbourDiscovery", host);
+    if (!mod)
+        opp_error("FlatNetworkConfigurator6: IPv6NeighbourDiscovery module `neighbourDiscovery' not found in `%s'",
+                  host->getFullPath().c_str());
+    return check_and_cast<IPv6NeighbourDiscovery *>(mod);
+}
+
+void FlatNetworkConfigurator6::disableAutoconfiguration(cTopology& topo)
+{
+    // assign final link-local addresses right away, instead of Neighbour Discovery
+    // doing it after a random bootup time and DAD
+    for (int i = 0; i < topo.getNumNodes(); i++)
+    {
+        cTopology::Node *node = topo.getNode(i);
+        if (!isIPNode(node))
+            continue;
+
+        neighbourDiscoveryOf(node->getModule())->disableAutoconfiguration();
+
+        IInterfaceTable *ift = IPAddressResolver().interfaceTableOf(node->getModule());
+        for (int k = 0; k < ift->getNumInterfaces(); k++)
+        {
+            InterfaceEntry *ie = ift->getInterface(k);
+            if (!ie->ipv6Data() || ie->isLoopback())
+                continue;
+
+            IPv6Address linkLocalAddr = ie->ipv6Data()->getLinkLocalAddress();
+            if (linkLocalAddr.isUnspecified())
+                ie->ipv6Data()->assignAddress(IPv6Address::formLinkLocalAddress(ie->getInterfaceToken()), false, 0, 0);
+            else if (ie->ipv6Data()->isTentativeAddress(linkLocalAddr))
+                ie->ipv6Data()->permanentlyAssign(linkLocalAddr);
+        }
+    }
+}
+
+void FlatNetworkConfigurator6::configureHostsFromAdvPrefixes(cTopology& topo)
+{
+    // do on hosts what processing the routers' first Router Advertisement would
+    // do: on-link prefixes, autoconfigured addresses, default routes. Lifetimes
+    // are infinite, as no further advertisements will come.
+    int numAddresses = 0;
+    for (int i = 0; i < topo.getNumNodes(); i++)
+    {
+        cTopology::Node *node = topo.getNode(i);
+        if (!isIPNode(node))
+            continue;
+
+        RoutingTable6 *rt = IPAddressResolver().routingTable6Of(node->getModule());
+        IInterfaceTable *ift = IPAddressResolver().interfaceTableOf(node->getModule());
+
+        // skip routers
+        if (rt->par("isRouter").boolValue())
+            continue;
+
+        for (int k = 0; k < ift->getNumInterfaces(); k++)
+        {
+            InterfaceEntry *ie = ift->getInterface(k);
+            if (!ie->ipv6Data() || ie->isLoopback())
+                continue;
+
+            LinkNeighbourList neighbours;
+            findLinkNeighbours(node, ie, neighbours);
+            for (unsigned int j = 0; j < neighbours.size(); j++)
+            {
+                IPv6InterfaceData *routerData = neighbours[j].ie->ipv6Data();
+                if (!routerData || !routerData->getAdvSendAdvertisements())
+                    continue;  // not an advertising router interface
+
+                for (int y = 0; y < routerData->getNumAdvPrefixes(); y++)
+                {
+                    const IPv6InterfaceData::AdvPrefix& p = routerData->getAdvPrefix(y);
+                    if (p.prefix.isLinkLocal())
+                        continue;
+                    if (p.advOnLinkFlag)
+                        rt->addOrUpdateOnLinkPrefix(p.prefix, p.prefixLength, ie->getInterfaceId(), 0);
+                    if (p.advAutonomousFlag)
+                    {
+                        bool hasMatchingAddress = false;
+                        for (int a = 0; a < ie->ipv6Data()->getNumAddresses(); a++)
+                            if (ie->ipv6Data()->getAddress(a).matches(p.prefix, p.prefixLength))
+                                hasMatchingAddress = true;
+                        if (!hasMatchingAddress)
+                        {
+                            IPv6Address addr = ie->ipv6Data()->getLinkLocalAddress();
+                            addr.setPrefix(p.prefix, p.prefixLength);
+                            ie->ipv6Data()->assignAddress(addr, false, 0, 0);
+                            numAddresses++;
+                        }
+                    }
+                }
+
+                if (routerData->getAdvDefaultLifetime() != 0)
+                    rt->addDefaultRoute(routerData->getLinkLocalAddress(), ie->getInterfaceId(), 0);
+            }
+        }
+    }
+    EV << numAddresses << " host addresses autoconfigured\n";
+}
+
+void FlatNetworkConfigurator6::fillNeighbourCaches(cTopology& topo)
+{
+    // add every address of every neighbour on the link to the neighbour
+    // cache, so that no Address Resolution will be needed
+    int numEntries = 0;
+    for (int i = 0; i < topo.getNumNodes(); i++)
+    {
+        cTopology::Node *node = topo.getNode(i);
+        if (!isIPNode(node))
+            continue;
 
+        IInterfaceTable *ift = IPAddressResolver().interfaceTableOf(node->getModule());
+        IPv6NeighbourDiscovery *nd = neighbourDiscoveryOf(node->getModule());
+        bool isRouter = IPAddressResolver().routingTable6Of(node->getModule())->par("isRouter").boolValue();
 
+        for (int k = 0; k < ift->getNumInterfaces(); k++)
+        {
+            InterfaceEntry *ie = ift->getInterface(k);
+            if (!ie->ipv6Data() || ie->isLoopback())
+                continue;
+
+            LinkNeighbourList neighbours;
+            findLinkNeighbours(node, ie, neighbours);
+            for (unsigned int j = 0; j < neighbours.size(); j++)
+            {
+                InterfaceEntry *neighbourIf = neighbours[j].ie;
+                if (!neighbourIf->ipv6Data())
+                    continue;
+                bool neighbourIsRouter = IPAddressResolver().routingTable6Of(neighbours[j].node->getModule())->par("isRouter").boolValue();
+                // hosts put advertising routers on their Default Router List (see configureHostsFromAdvPrefixes())
+                bool isDefaultRouter = !isRouter && neighbourIsRouter && neighbourIf->ipv6Data()->getAdvSendAdvertisements()
+                                       && neighbourIf->ipv6Data()->getAdvDefaultLifetime() != 0;
+
+                // PPP interfaces have no MAC address; an entry with an unspecified
+                // one is fine for them, as PPP ignores the link-layer address
+                for (int a = 0; a < neighbourIf->ipv6Data()->getNumAddresses(); a++)
+                {
+                    const IPv6Address& addr = neighbourIf->ipv6Data()->getAddress(a);
+                    nd->addStaticNeighbour(addr, ie->getInterfaceId(), neighbourIf->getMacAddress(),
+                                           neighbourIsRouter, isDefaultRouter && addr.isLinkLocal());
+                    numEntries++;
+                }
+            }
+        }
+    }
+    EV << numEntries << " neighbour cache entries added\n";
+}
+
+void FlatNetworkConfigurator6::findLinkNeighbours(cTopology::Node *node, InterfaceEntry *ie, LinkNeighbourList& result)
+{
+    // start from the link(s) of the given interface
+    IInterfaceTable *ift = IPAddressResolver().interfaceTableOf(node->getModule());
+    std::vector<cTopology::LinkOut *> links;
+    for (int k = 0; k < node->getNumOutLinks(); k++)
+        if (ift->getInterfaceByNodeOutputGateId(node->getLinkOut(k)->getLocalGate()->getId()) == ie)
+            links.push_back(node->getLinkOut(k));
+
+    // IP nodes at the other end are neighbours; non-IP nodes (Ethernet
+    // switches etc) are seeked through, as they belong to the same link
+    std::set<cTopology::Node *> visited;
+    visited.insert(node);
+    while (!links.empty())
+    {
+        cTopology::LinkOut *link = links.back();
+        links.pop_back();
+        cTopology::Node *remoteNode = link->getRemoteNode();
+        if (visited.find(remoteNode) != visited.end())
+            continue;
+        visited.insert(remoteNode);
+
+        if (isIPNode(remoteNode))
+        {
+            IInterfaceTable *remoteIft = IPAddressResolver().interfaceTableOf(remoteNode->getModule());
+            LinkNeighbour neighbour;
+            neighbour.node = remoteNode;
+            neighbour.ie = remoteIft->getInterfaceByNodeInputGateId(link->getRemoteGate()->getId());
+            if (neighbour.ie)
+                result.push_back(neighbour);
+        }
+        else
+        {
+            for (int k = 0; k < remoteNode->getNumOutLinks(); k++)
+                links.push_back(remoteNode->getLinkOut(k));
+        }
+    }
+}
+#endif
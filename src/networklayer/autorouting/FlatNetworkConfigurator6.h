@@ -19,9 +19,12 @@
 #ifndef __INET_FLATNETWORKCONFIGURATOR6_H
 #define __INET_FLATNETWORKCONFIGURATOR6_H
 
+#include <vector>
 #include <omnetpp.h>
 #include "INETDefs.h"
 
+class InterfaceEntry;
+
 
 /**
  * Configures IPv6 addresses and routing tables for a "flat" network,
@@ -32,15 +35,38 @@
  */
 class INET_API FlatNetworkConfigurator6 : public cSimpleModule
 {
+  protected:
+    // an interface of an IP node, as seen from its neighbours on the link
+    struct LinkNeighbour
+    {
+        cTopology::Node *node;
+        InterfaceEntry *ie;
+    };
+    typedef std::vector<LinkNeighbour> LinkNeighbourList;
+
+    bool fastStart;
+
+    // CPU time spent in the configuration steps, in seconds
+    double prefixSetupTime;
+    double routeSetupTime;
+    double fastStartSetupTime;
+
   protected:
     virtual int numInitStages() const  {return 4;}
     virtual void initialize(int stage);
     virtual void handleMessage(cMessage *msg);
+    virtual void finish();
 
     virtual void configureAdvPrefixes(cTopology& topo);
     virtual void addOwnAdvPrefixRoutes(cTopology& topo);
     virtual void addStaticRoutes(cTopology& topo);
 
+    // fastStart: the work of Neighbour Discovery's startup procedures
+    virtual void disableAutoconfiguration(cTopology& topo);
+    virtual void configureHostsFromAdvPrefixes(cTopology& topo);
+    virtual void fillNeighbourCaches(cTopology& topo);
+    virtual void findLinkNeighbours(cTopology::Node *node, InterfaceEntry *ie, LinkNeighbourList& result);
+
     virtual void setDisplayString(int numIPNodes, int numNonIPNodes);
     virtual bool isIPNode(cTopology::Node *node);
 };
@@ -70,6 +70,9 @@ void NetworkConfigurator::extractTopology(cTopology& topo, NodeInfoVector& nodeI
     for (int i=0; i<topo.getNumNodes(); i++)
     {
         cModule *mod = topo.getNode(i)->getModule();
+        if (mod->isPlaceholder())
+            error("%s is in another partition: the network configurator cannot be used with "
+                  "a network split across partitions of a parallel simulation", mod->getFullPath().c_str());
         nodeInfo[i].ift = IPAddressResolver().findInterfaceTableOf(mod);
         nodeInfo[i].rt = IPAddressResolver().findRoutingTableOf(mod);
         nodeInfo[i].isIPNode = nodeInfo[i].rt!=NULL;
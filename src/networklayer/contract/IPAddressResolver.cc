@@ -213,8 +213,18 @@ IPv6Address IPAddressResolver::getInterfaceIPv6Address(InterfaceEntry *ie)
 #endif
 }
 
+static void checkLocal(cModule *host)
+{
+    // with parallel simulation, modules in other partitions are placeholders without submodules
+    if (host->isPlaceholder())
+        opp_error("IPAddressResolver: host/router `%s' is in another partition of the parallel "
+                  "simulation, its tables cannot be accessed", host->getFullPath().c_str());
+}
+
 IInterfaceTable *IPAddressResolver::interfaceTableOf(cModule *host)
 {
+    checkLocal(host);
+
     // find IInterfaceTable
     cModule *mod = host->getSubmodule("interfaceTable");
     if (!mod)
@@ -225,6 +235,8 @@ IInterfaceTable *IPAddressResolver::interfaceTableOf(cModule *host)
 
 IRoutingTable *IPAddressResolver::routingTableOf(cModule *host)
 {
+    checkLocal(host);
+
     // find IRoutingTable
     cModule *mod = host->getSubmodule("routingTable");
     if (!mod)
@@ -236,6 +248,8 @@ IRoutingTable *IPAddressResolver::routingTableOf(cModule *host)
 #ifndef WITHOUT_IPv6
 RoutingTable6 *IPAddressResolver::routingTable6Of(cModule *host)
 {
+    checkLocal(host);
+
     // find IRoutingTable
     cModule *mod = host->getSubmodule("routingTable6");
     if (!mod)
@@ -247,6 +261,8 @@ RoutingTable6 *IPAddressResolver::routingTable6Of(cModule *host)
 
 NotificationBoard *IPAddressResolver::notificationBoardOf(cModule *host)
 {
+    checkLocal(host);
+
     // find NotificationBoard
     cModule *mod = host->getSubmodule("notificationBoard");
     if (!mod)
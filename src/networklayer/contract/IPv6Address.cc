@@ -20,6 +20,7 @@
 #include <sstream>
 #include "IPv6Address.h"
 #include "InterfaceToken.h"
+#include "HashMap.h"
 
 const uint32 LINK_LOCAL_PREFIX = 0xFE800000;
 const uint32 SITE_LOCAL_PREFIX = 0xFEC00000;
@@ -203,6 +204,11 @@ std::string IPv6Address::str() const
     return os.str();
 }
 
+size_t IPv6Address::hash() const
+{
+    return inet_hashInt(d[0] ^ (d[1] * 0x9e3779b9U) ^ (d[2] * 0x85ebca6bU) ^ (d[3] * 0xc2b2ae35U));
+}
+
 IPv6Address::Scope IPv6Address::getScope() const
 {
     //Mask the given IPv6 address with the different mask types
@@ -132,6 +132,11 @@ class INET_API IPv6Address
                    d[3]<addr.d[3] ? -1 : d[3]>addr.d[3] ? 1 : 0;
         }
 
+        /**
+         * Returns a hash value of the address, for use in hash tables.
+         */
+        size_t hash() const;
+
         /**
          *  Try parsing an IPv6 address.
          *  Return true if the string contained a well-formed IPv6 address,
@@ -291,6 +296,15 @@ class INET_API IPv6AddressPrefix : public IPv6Address
 };
 */
 
+/**
+ * Hash functor for IPv6Address, for use with inet_hash::unordered_map
+ * (see HashMap.h).
+ */
+struct IPv6AddressHash
+{
+    size_t operator()(const IPv6Address& addr) const {return addr.hash();}
+};
+
 inline std::ostream& operator<<(std::ostream& os, const IPv6Address& ip)
 {
     return os << ip.str();
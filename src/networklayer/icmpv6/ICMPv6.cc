@@ -129,7 +129,7 @@ void ICMPv6::sendEchoRequest(cPacket *msg)
 
 void ICMPv6::sendErrorMessage(IPv6Datagram *origDatagram, ICMPv6Type type, int code)
 {
-    Enter_Method("sendErrorMessage(datagram, type=%d, code=%d)", type, code);
+    Enter_Method_Lite("sendErrorMessage(datagram, type=%d, code=%d)", type, code);
 
     // get ownership
     take(origDatagram);
@@ -177,7 +177,7 @@ void ICMPv6::sendErrorMessage(IPv6Datagram *origDatagram, ICMPv6Type type, int c
 
 void ICMPv6::sendErrorMessage(cPacket *transportPacket, IPv6ControlInfo *ctrl, ICMPv6Type type, int code)
 {
-    Enter_Method("sendErrorMessage(transportPacket, ctrl, type=%d, code=%d)", type, code);
+    Enter_Method_Lite("sendErrorMessage(transportPacket, ctrl, type=%d, code=%d)", type, code);
 
     IPv6Datagram *datagram = ctrl->removeOrigDatagram();
     datagram->encapsulate(transportPacket);
@@ -33,6 +33,7 @@ Define_Module(IPv6NeighbourDiscovery);
 
 IPv6NeighbourDiscovery::IPv6NeighbourDiscovery()
 {
+    autoconfigEnabled = true;
 }
 
 IPv6NeighbourDiscovery::~IPv6NeighbourDiscovery()
@@ -58,6 +59,13 @@ void IPv6NeighbourDiscovery::initialize(int stage)
         icmpv6 = ICMPv6Access().get();
         pendingQueue.setName("pendingQueue");
 
+        if (!autoconfigEnabled)
+        {
+            EV << "Autoconfiguration disabled by the network configurator, "
+               << "no link-local address assignment, DAD, Router Discovery and Advertisements\n";
+            return;
+        }
+
         for (int i=0; i < ift->getNumInterfaces(); i++)
         {
             InterfaceEntry *ie = ift->getInterface(i);
@@ -285,7 +293,7 @@ IPv6NeighbourDiscovery::RDEntry *IPv6NeighbourDiscovery::fetchRDEntry(InterfaceE
 
 const MACAddress& IPv6NeighbourDiscovery::resolveNeighbour(const IPv6Address& nextHop, int interfaceId)
 {
-    Enter_Method("resolveNeighbor(%s,if=%d)", nextHop.str().c_str(), interfaceId);
+    Enter_Method_Lite("resolveNeighbor(%s,if=%d)", nextHop.str().c_str(), interfaceId);
 
     Neighbour *nce = neighbourCache.lookup(nextHop, interfaceId);
     //InterfaceEntry *ie = ift->getInterfaceById(interfaceId);
@@ -311,9 +319,31 @@ const MACAddress& IPv6NeighbourDiscovery::resolveNeighbour(const IPv6Address& ne
     return nce->macAddress;
 }
 
+void IPv6NeighbourDiscovery::disableAutoconfiguration()
+{
+    Enter_Method_Silent();
+    autoconfigEnabled = false;
+}
+
+void IPv6NeighbourDiscovery::addStaticNeighbour(const IPv6Address& addr, int interfaceId,
+    const MACAddress& macAddress, bool isRouter, bool isDefaultRouter)
+{
+    Enter_Method_Silent();
+
+    if (neighbourCache.lookup(addr, interfaceId))
+        neighbourCache.remove(addr, interfaceId);
+
+    Neighbour *nce = isDefaultRouter ?
+        neighbourCache.addRouter(addr, interfaceId, macAddress, MAXTIME) :
+        neighbourCache.addNeighbour(addr, interfaceId, macAddress);
+    nce->isRouter = isRouter;
+    nce->reachabilityState = IPv6NeighbourCache::REACHABLE;
+    nce->reachabilityExpires = MAXTIME;
+}
+
 void IPv6NeighbourDiscovery::reachabilityConfirmed(const IPv6Address& neighbour, int interfaceId)
 {
-    Enter_Method("reachabilityConfirmed(%s,if=%d)", neighbour.str().c_str(), interfaceId);
+    Enter_Method_Lite("reachabilityConfirmed(%s,if=%d)", neighbour.str().c_str(), interfaceId);
     //hmmm... this should only be invoked if a TCP ACK was received and NUD is
     //currently being performed on the neighbour where the TCP ACK was received from.
 
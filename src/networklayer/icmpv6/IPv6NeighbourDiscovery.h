@@ -82,6 +82,24 @@ class INET_API IPv6NeighbourDiscovery : public cSimpleModule
          */
         virtual void reachabilityConfirmed(const IPv6Address& neighbour, int interfaceId);
 
+        /**
+         * For network configurators that set up addresses, routes and the
+         * neighbour cache themselves. Must be called before initialization
+         * stage 3: link-local address assignment, Duplicate Address Detection,
+         * Router Discovery and Router Advertisements will then not be started.
+         */
+        virtual void disableAutoconfiguration();
+
+        /**
+         * For network configurators: adds a neighbour cache entry that is
+         * REACHABLE and never expires, so no Address Resolution or Neighbour
+         * Unreachability Detection will be done for it. If isDefaultRouter
+         * is true, the neighbour is also put on the Default Router List
+         * (with infinite router lifetime). An existing entry is overwritten.
+         */
+        virtual void addStaticNeighbour(const IPv6Address& addr, int interfaceId,
+            const MACAddress& macAddress, bool isRouter, bool isDefaultRouter);
+
     protected:
 
         //Packets awaiting Address Resolution or Next-Hop Determination.
@@ -91,6 +109,7 @@ class INET_API IPv6NeighbourDiscovery : public cSimpleModule
         RoutingTable6 *rt6;
         ICMPv6 *icmpv6;
         IPv6NeighbourCache neighbourCache;
+        bool autoconfigEnabled; // false if a configurator has set up everything
         typedef std::set<cMessage*> RATimerList;
 
         // stores information about a pending Duplicate Address Detection for
@@ -50,7 +50,7 @@ void ICMP::handleMessage(cMessage *msg)
 
 void ICMP::sendErrorMessage(IPDatagram *origDatagram, ICMPType type, ICMPCode code)
 {
-    Enter_Method("sendErrorMessage(datagram, type=%d, code=%d)", type, code);
+    Enter_Method_Lite("sendErrorMessage(datagram, type=%d, code=%d)", type, code);
 
     // get ownership
     take(origDatagram);
@@ -64,7 +64,8 @@ void ICMP::sendErrorMessage(IPDatagram *origDatagram, ICMPType type, ICMPCode co
     }
 
     // do not reply with error message to error message
-    if (origDatagram->getTransportProtocol() == IP_PROT_ICMP)
+    // (fragments other than the last one carry no encapsulated packet)
+    if (origDatagram->getTransportProtocol() == IP_PROT_ICMP && origDatagram->getEncapsulatedMsg())
     {
         ICMPMessage *recICMPMsg = check_and_cast<ICMPMessage *>(origDatagram->getEncapsulatedMsg());
         if (recICMPMsg->getType()<128)
@@ -122,7 +123,7 @@ void ICMP::sendErrorMessage(IPDatagram *origDatagram, ICMPType type, ICMPCode co
 
 void ICMP::sendErrorMessage(cPacket *transportPacket, IPControlInfo *ctrl, ICMPType type, ICMPCode code)
 {
-    Enter_Method("sendErrorMessage(transportPacket, ctrl, type=%d, code=%d)", type, code);
+    Enter_Method_Lite("sendErrorMessage(transportPacket, ctrl, type=%d, code=%d)", type, code);
 
     IPDatagram *datagram = ctrl->removeOrigDatagram();
     take(transportPacket);
@@ -44,17 +44,27 @@ void IP::initialize()
     fragmentTimeoutTime = par("fragmentTimeout");
     mapping.parseProtocolMapping(par("protocolMapping"));
 
+    // the fast path would skip the service time, so it needs procDelay=0
+    fastForwarding = par("fastForwarding");
+    if (fastForwarding && delay!=0)
+    {
+        EV << "procDelay is nonzero, fast forwarding disabled\n";
+        fastForwarding = false;
+    }
+    fastPathResolved = false;
+
     curFragmentId = 0;
     lastCheckTime = 0;
     fragbuf.init(icmpAccess.get());
 
-    numMulticast = numLocalDeliver = numDropped = numUnroutable = numForwarded = 0;
+    numMulticast = numLocalDeliver = numDropped = numUnroutable = numForwarded = numFastForwarded = 0;
 
     WATCH(numMulticast);
     WATCH(numLocalDeliver);
     WATCH(numDropped);
     WATCH(numUnroutable);
     WATCH(numForwarded);
+    WATCH(numFastForwarded);
 }
 
 void IP::updateDisplayString()
@@ -459,39 +469,58 @@ void IP::fragmentAndSend(IPDatagram *datagram, InterfaceEntry *ie, IPAddress nex
 
     // create and send fragments
     EV << "Breaking datagram into " << noOfFragments << " fragments\n";
+    std::vector<IPDatagram *> fragments;
+    createFragments(datagram, mtu, noOfFragments, fragments);
+    for (unsigned int i=0; i<fragments.size(); i++)
+        sendDatagramToOutput(fragments[i], ie, nextHopAddr);
+}
+
+void IP::createFragments(IPDatagram *datagram, int mtu, int noOfFragments, std::vector<IPDatagram *>& fragments)
+{
+    int headerLength = datagram->getHeaderLength();
     std::string fragMsgName = datagram->getName();
     fragMsgName += "-frag";
 
-    // FIXME revise this!
-    for (int i=0; i<noOfFragments; i++)
+    // The encapsulated packet travels in the last fragment only (IPFragBuf
+    // keeps whichever fragment carries it); the other fragments are
+    // header-only copies of the datagram, so we don't dup() the payload.
+    // The original datagram object itself becomes the last fragment.
+    // When re-fragmenting a fragment, offsets are relative to its own offset.
+    int offsetBase = datagram->getFragmentOffset();
+    int lastFragmentBytes = datagram->getByteLength() - (noOfFragments-1) * (mtu - headerLength);
+    cPacket *payloadPacket = NULL;
+    if (datagram->getEncapsulatedMsg())
     {
-        // FIXME is it ok that full encapsulated packet travels in every datagram fragment?
-        // should better travel in the last fragment only. Cf. with reassembly code!
-        IPDatagram *fragment = (IPDatagram *) datagram->dup();
-        fragment->setName(fragMsgName.c_str());
+        // a last fragment is shorter than the packet it carries, and
+        // decapsulate() would refuse to make its length negative
+        datagram->setByteLength(headerLength + datagram->getEncapsulatedMsg()->getByteLength());
+        payloadPacket = datagram->decapsulate();
+    }
 
+    for (int i=0; i<noOfFragments; i++)
+    {
         // total_length equal to mtu, except for last fragment;
         // "more fragments" bit is unchanged in the last fragment, otherwise true
+        IPDatagram *fragment;
         if (i != noOfFragments-1)
         {
+            fragment = datagram->dup();
             fragment->setMoreFragments(true);
             fragment->setByteLength(mtu);
         }
         else
         {
-            // size of last fragment
-            int bytes = datagram->getByteLength() - (noOfFragments-1) * (mtu - datagram->getHeaderLength());
-            fragment->setByteLength(bytes);
+            fragment = datagram;
+            if (payloadPacket)
+                fragment->encapsulate(payloadPacket);
+            fragment->setByteLength(lastFragmentBytes);
         }
-        fragment->setFragmentOffset( i*(mtu - datagram->getHeaderLength()) );
-
-        sendDatagramToOutput(fragment, ie, nextHopAddr);
+        fragment->setName(fragMsgName.c_str());
+        fragment->setFragmentOffset(offsetBase + i*(mtu - headerLength));
+        fragments.push_back(fragment);
     }
-
-    delete datagram;
 }
 
-
 IPDatagram *IP::encapsulate(cPacket *transportPacket, InterfaceEntry *&destIE)
 {
     IPControlInfo *controlInfo = check_and_cast<IPControlInfo*>(transportPacket->removeControlInfo());
@@ -568,6 +597,26 @@ void IP::sendDatagramToOutput(IPDatagram *datagram, InterfaceEntry *ie, IPAddres
         return;
     }
 
+    if (fastForwarding)
+    {
+        if (!fastPathResolved)
+            resolveFastPathQueues();
+
+        // insert directly into the output queue; all datagrams for the
+        // interface take this path so they stay in order, but they may now
+        // arrive before other events at the same simulation time (e.g. the
+        // PPP module asking for the next packet)
+        int gateIndex = ie->getNetworkLayerGateIndex();
+        PassiveQueueBase *outputQueue = gateIndex>=0 && gateIndex<(int)fastPathQueues.size() ? fastPathQueues[gateIndex] : NULL;
+        if (outputQueue)
+        {
+            EV << "fast path: inserting datagram into output queue " << outputQueue->getFullPath() << "\n";
+            numFastForwarded++;
+            outputQueue->receiveDirect(datagram);
+            return;
+        }
+    }
+
     // send out datagram to ARP, with control info attached
     IPRoutingDecision *routingDecision = new IPRoutingDecision();
     routingDecision->setInterfaceId(ie->getInterfaceId());
@@ -577,4 +626,29 @@ void IP::sendDatagramToOutput(IPDatagram *datagram, InterfaceEntry *ie, IPAddres
     send(datagram, queueOutGate);
 }
 
+void IP::resolveFastPathQueues()
+{
+    fastPathResolved = true;
+    fastPathQueues.clear();
+
+    // ARP only passes datagrams through for non-broadcast interfaces
+    cModule *arp = queueOutGate->getPathEndGate()->getOwnerModule();
+    for (int i=0; i<ift->getNumInterfaces(); i++)
+    {
+        InterfaceEntry *ie = ift->getInterface(i);
+        int gateIndex = ie->getNetworkLayerGateIndex();
+        if (ie->isBroadcast() || gateIndex<0 || arp->findGate("nicOut", gateIndex)<0)
+            continue;
+
+        cGate *queueInGate = arp->gate("nicOut", gateIndex)->getPathEndGate();
+        PassiveQueueBase *outputQueue = dynamic_cast<PassiveQueueBase *>(queueInGate->getOwnerModule());
+        if (!outputQueue)
+            continue;
+
+        if (gateIndex >= (int)fastPathQueues.size())
+            fastPathQueues.resize(gateIndex+1, NULL);
+        fastPathQueues[gateIndex] = outputQueue;
+        EV << "fast path: datagrams for " << ie->getName() << " go directly into " << outputQueue->getFullPath() << "\n";
+    }
+}
 
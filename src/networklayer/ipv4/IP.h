@@ -18,6 +18,7 @@
 #ifndef __INET_IP_H
 #define __INET_IP_H
 
+#include <vector>
 #include "QueueBase.h"
 #include "InterfaceTableAccess.h"
 #include "RoutingTableAccess.h"
@@ -27,6 +28,7 @@
 #include "IPDatagram.h"
 #include "IPFragBuf.h"
 #include "ProtocolMap.h"
+#include "PassiveQueueBase.h"
 
 
 class ARPPacket;
@@ -51,6 +53,7 @@ class INET_API IP : public QueueBase
     int defaultTimeToLive;
     int defaultMCTimeToLive;
     simtime_t fragmentTimeoutTime;
+    bool fastForwarding;
 
     // working vars
     long curFragmentId; // counter, used to assign unique fragmentIds to datagrams
@@ -58,12 +61,18 @@ class INET_API IP : public QueueBase
     simtime_t lastCheckTime; // when fragbuf was last checked for state fragments
     ProtocolMapping mapping; // where to send packets after decapsulation
 
+    // fast forwarding: output queues by network layer gate index
+    // (NULL where datagrams have to go through ARP)
+    bool fastPathResolved;
+    std::vector<PassiveQueueBase *> fastPathQueues;
+
     // statistics
     int numMulticast;
     int numLocalDeliver;
     int numDropped;
     int numUnroutable;
     int numForwarded;
+    int numFastForwarded;
 
   protected:
     // utility: look up interface from getArrivalGate()
@@ -147,9 +156,25 @@ class INET_API IP : public QueueBase
      */
     virtual void sendDatagramToOutput(IPDatagram *datagram, InterfaceEntry *ie, IPAddress nextHopAddr);
 
+    /**
+     * Looks up the output queues datagrams can be inserted into directly,
+     * i.e. those of non-broadcast interfaces where ARP would just pass the
+     * datagram through. Called on first use, with fastForwarding on.
+     */
+    virtual void resolveFastPathQueues();
+
   public:
     IP() {}
 
+    /**
+     * Breaks the datagram into noOfFragments fragments of at most mtu bytes,
+     * and appends them to the fragments vector. The datagram itself becomes
+     * the last fragment, and only that one carries the encapsulated packet.
+     * Also works for datagrams that are already fragments. Static so that
+     * it can be used (and tested) without an IP module.
+     */
+    static void createFragments(IPDatagram *datagram, int mtu, int noOfFragments, std::vector<IPDatagram *>& fragments);
+
   protected:
     /**
      * Initialization
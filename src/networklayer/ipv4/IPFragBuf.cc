@@ -31,6 +31,8 @@ IPFragBuf::IPFragBuf()
 
 IPFragBuf::~IPFragBuf()
 {
+    for (Buffers::iterator i=bufs.begin(); i!=bufs.end(); ++i)
+        delete i->datagram;
 }
 
 void IPFragBuf::init(ICMP *icmp)
@@ -46,20 +48,24 @@ IPDatagram *IPFragBuf::addFragment(IPDatagram *datagram, simtime_t now)
     key.src = datagram->getSrcAddress();
     key.dest = datagram->getDestAddress();
 
-    Buffers::iterator i = bufs.find(key);
+    BufferIndex::iterator i = index.find(key);
 
-    DatagramBuffer *buf = NULL;
-    if (i==bufs.end())
+    Buffers::iterator bufIt;
+    if (i==index.end())
     {
         // this is the first fragment of that datagram, create reassembly buffer for it
-        buf = &bufs[key];
-        buf->datagram = NULL;
+        bufIt = bufs.insert(bufs.end(), DatagramBuffer());
+        bufIt->key = key;
+        bufIt->datagram = NULL;
+        i = index.insert(std::make_pair(key, bufIt)).first;
     }
     else
     {
-        // use existing buffer
-        buf = &(i->second);
+        // use existing buffer, and move it to the end of the age-ordered list
+        bufIt = i->second;
+        bufs.splice(bufs.end(), bufs, bufIt);
     }
+    DatagramBuffer *buf = &(*bufIt);
 
     // add fragment into reassembly buffer
     int bytes = datagram->getByteLength() - datagram->getHeaderLength();
@@ -68,9 +74,10 @@ IPDatagram *IPFragBuf::addFragment(IPDatagram *datagram, simtime_t now)
                                            !datagram->getMoreFragments());
 
     // store datagram. Only one fragment carries the actual modelled
-    // content (getEncapsulatedMsg()), other (empty) ones are only
-    // preserved so that we can send them in ICMP if reassembly times out.
-    if (datagram->getEncapsulatedMsg())
+    // content (getEncapsulatedMsg()), the other (empty) ones are only
+    // kept until it arrives, so that we can send them in ICMP if
+    // reassembly times out.
+    if (!buf->datagram || datagram->getEncapsulatedMsg())
     {
         delete buf->datagram;
         buf->datagram = datagram;
@@ -88,7 +95,8 @@ IPDatagram *IPFragBuf::addFragment(IPDatagram *datagram, simtime_t now)
         ret->setByteLength(ret->getHeaderLength()+buf->buf.getTotalLength());
         ret->setFragmentOffset(0);
         ret->setMoreFragments(false);
-        bufs.erase(i);
+        index.erase(i);
+        bufs.erase(bufIt);
         return ret;
     }
     else
@@ -101,32 +109,24 @@ IPDatagram *IPFragBuf::addFragment(IPDatagram *datagram, simtime_t now)
 
 void IPFragBuf::purgeStaleFragments(simtime_t lastupdate)
 {
-    // this method shouldn't be called too often because iteration on
-    // an std::map is *very* slow...
+    // buffers are ordered by last update time, so we can stop at
+    // the first one which is not yet stale
 
     ASSERT(icmpModule);
 
-    for (Buffers::iterator i=bufs.begin(); i!=bufs.end(); )
+    while (!bufs.empty() && bufs.front().lastupdate < lastupdate)
     {
-        // if too old, remove it
-        DatagramBuffer& buf = i->second;
-        if (buf.lastupdate < lastupdate)
-        {
-            // send ICMP error.
-            // Note: receiver MUST NOT call decapsulate() on the datagram fragment,
-            // because its length (being a fragment) is smaller than the encapsulated
-            // packet, resulting in "length became negative" error. Use getEncapsulatedMsg().
-            EV << "datagram fragment timed out in reassembly buffer, sending ICMP_TIME_EXCEEDED\n";
-            icmpModule->sendErrorMessage(buf.datagram, ICMP_TIME_EXCEEDED, 0);
-
-            // delete
-            Buffers::iterator oldi = i++;
-            bufs.erase(oldi);
-        }
-        else
-        {
-            ++i;
-        }
+        // send ICMP error.
+        // Note: receiver MUST NOT call decapsulate() on the datagram fragment,
+        // because its length (being a fragment) is smaller than the encapsulated
+        // packet, resulting in "length became negative" error. Use getEncapsulatedMsg().
+        DatagramBuffer& buf = bufs.front();
+        EV << "datagram fragment timed out in reassembly buffer, sending ICMP_TIME_EXCEEDED\n";
+        icmpModule->sendErrorMessage(buf.datagram, ICMP_TIME_EXCEEDED, 0);
+
+        // delete
+        index.erase(buf.key);
+        bufs.pop_front();
     }
 }
 
@@ -18,9 +18,9 @@
 #ifndef __INET_IPFRAGBUF_H
 #define __INET_IPFRAGBUF_H
 
-#include <map>
-#include <vector>
+#include <list>
 #include "INETDefs.h"
+#include "HashMap.h"
 #include "ReassemblyBuffer.h"
 #include "IPDatagram.h"
 
@@ -43,8 +43,15 @@ class INET_API IPFragBuf
         IPAddress src;
         IPAddress dest;
 
-        inline bool operator<(const Key& b) const {
-            return (id!=b.id) ? (id<b.id) : (src!=b.src) ? (src<b.src) : (dest<b.dest);
+        inline bool operator==(const Key& b) const {
+            return id==b.id && src==b.src && dest==b.dest;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& k) const {
+            return inet_hashInt(k.src.getInt() ^ (k.dest.getInt() << 11) ^ ((unsigned int)k.id << 16 | k.id));
         }
     };
 
@@ -53,16 +60,24 @@ class INET_API IPFragBuf
     //
     struct DatagramBuffer
     {
+        Key key;               // key of this buffer in the index
         ReassemblyBuffer buf;  // reassembly buffer
         IPDatagram *datagram;  // the actual datagram
         simtime_t lastupdate;  // last time a new fragment arrived
     };
 
-    // we use std::map for fast lookup by datagram Id
-    typedef std::map<Key,DatagramBuffer> Buffers;
+    //
+    // Buffers are kept in a list ordered by lastupdate (a buffer is moved
+    // to the end whenever a fragment arrives for it), so stale buffers
+    // are always at the front and purging does not need to scan the rest.
+    // The hash table indexes the list by datagram Id.
+    //
+    typedef std::list<DatagramBuffer> Buffers;
+    typedef inet_hash::unordered_map<Key,Buffers::iterator,KeyHash> BufferIndex;
 
-    // the reassembly buffers
+    // the reassembly buffers, oldest first
     Buffers bufs;
+    BufferIndex index;
 
     // needed for TIME_EXCEEDED errors
     ICMP *icmpModule;
@@ -97,8 +112,8 @@ class INET_API IPFragBuf
      * and sends ICMP TIME EXCEEDED message about them.
      *
      * Timeout should be between 60 seconds and 120 seconds (RFC1122).
-     * This method should be called more frequently, maybe every
-     * 10..30 seconds or so.
+     * The cost is proportional to the number of purged buffers only,
+     * so it may be called as often as needed.
      */
     void purgeStaleFragments(simtime_t lastupdate);
 };
@@ -195,6 +195,11 @@ void RoutingTable::receiveChangeNotification(int category, const cPolymorphic *d
         // if anything IPv4-related changes in the interfaces, interface netmask
         // based routes have to be re-built.
         updateNetmaskRoutes();
+
+        // with routerId="auto", interfaces may only get their addresses after
+        // stage 3 (e.g. from FlatNetworkConfigurator with parallel simulation)
+        if (routerId.isUnspecified())
+            configureRouterId();
     }
 }
 
@@ -255,7 +260,7 @@ void RoutingTable::configureInterfaceForIPv4(InterfaceEntry *ie)
 
 InterfaceEntry *RoutingTable::getInterfaceByAddress(const IPAddress& addr) const
 {
-    Enter_Method("getInterfaceByAddress(%u.%u.%u.%u)", addr.getDByte(0), addr.getDByte(1), addr.getDByte(2), addr.getDByte(3)); // note: str().c_str() too slow here
+    Enter_Method_Lite("getInterfaceByAddress(%u.%u.%u.%u)", addr.getDByte(0), addr.getDByte(1), addr.getDByte(2), addr.getDByte(3)); // note: str().c_str() too slow here
 
     if (addr.isUnspecified())
         return NULL;
@@ -286,7 +291,7 @@ void RoutingTable::configureLoopbackForIPv4()
 
 bool RoutingTable::isLocalAddress(const IPAddress& dest) const
 {
-    Enter_Method("isLocalAddress(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
+    Enter_Method_Lite("isLocalAddress(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
 
     if (localAddresses.empty())
     {
@@ -304,7 +309,7 @@ bool RoutingTable::isLocalAddress(const IPAddress& dest) const
 
 bool RoutingTable::isLocalMulticastAddress(const IPAddress& dest) const
 {
-    Enter_Method("isLocalMulticastAddress(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
+    Enter_Method_Lite("isLocalMulticastAddress(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
 
     for (int i=0; i<ift->getNumInterfaces(); i++)
     {
@@ -318,7 +323,7 @@ bool RoutingTable::isLocalMulticastAddress(const IPAddress& dest) const
 
 const IPRoute *RoutingTable::findBestMatchingRoute(const IPAddress& dest) const
 {
-    Enter_Method("findBestMatchingRoute(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
+    Enter_Method_Lite("findBestMatchingRoute(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
 
     RoutingCache::iterator it = routingCache.find(dest);
     if (it != routingCache.end())
@@ -344,7 +349,7 @@ const IPRoute *RoutingTable::findBestMatchingRoute(const IPAddress& dest) const
 
 InterfaceEntry *RoutingTable::getInterfaceForDestAddr(const IPAddress& dest) const
 {
-    Enter_Method("getInterfaceForDestAddr(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
+    Enter_Method_Lite("getInterfaceForDestAddr(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
 
     const IPRoute *e = findBestMatchingRoute(dest);
     return e ? e->getInterface() : NULL;
@@ -352,7 +357,7 @@ InterfaceEntry *RoutingTable::getInterfaceForDestAddr(const IPAddress& dest) con
 
 IPAddress RoutingTable::getGatewayForDestAddr(const IPAddress& dest) const
 {
-    Enter_Method("getGatewayForDestAddr(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
+    Enter_Method_Lite("getGatewayForDestAddr(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
 
     const IPRoute *e = findBestMatchingRoute(dest);
     return e ? e->getGateway() : IPAddress();
@@ -361,7 +366,7 @@ IPAddress RoutingTable::getGatewayForDestAddr(const IPAddress& dest) const
 
 MulticastRoutes RoutingTable::getMulticastRoutesFor(const IPAddress& dest) const
 {
-    Enter_Method("getMulticastRoutesFor(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here here
+    Enter_Method_Lite("getMulticastRoutesFor(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
 
     MulticastRoutes res;
     res.reserve(16);
@@ -70,14 +70,30 @@ std::ostream& operator<<(std::ostream& os, const RoutingTable6::DestCacheEntry&
     return os;
 };
 
+std::ostream& operator<<(std::ostream& os, const RoutingTable6::DestCache& destCache)
+{
+    os << destCache.size() << " entries:";
+    for (RoutingTable6::DestCache::const_iterator it = destCache.begin(); it != destCache.end(); ++it)
+        os << " " << it->first << "(" << it->second << ")";
+    return os;
+}
+
+// returns the given bit of the address, bit 0 being the most significant one
+static inline int addressBit(const IPv6Address& addr, int bit)
+{
+    return (addr.words()[bit>>5] >> (31-(bit&31))) & 1;
+}
+
 RoutingTable6::RoutingTable6()
 {
+    trieRoot = new RouteTrieNode();
 }
 
 RoutingTable6::~RoutingTable6()
 {
     for (unsigned int i=0; i<routeList.size(); i++)
         delete routeList[i];
+    deleteTrie(trieRoot);
 }
 
 void RoutingTable6::initialize(int stage)
@@ -94,7 +110,7 @@ void RoutingTable6::initialize(int stage)
         nb->subscribe(this, NF_INTERFACE_IPv6CONFIG_CHANGED);
 
         WATCH_PTRVECTOR(routeList);
-        WATCH_MAP(destCache); // FIXME commented out for now
+        WATCH(destCache);
         isrouter = par("isRouter");
         WATCH(isrouter);
 
@@ -353,7 +369,7 @@ void RoutingTable6::configureInterfaceFromXML(InterfaceEntry *ie, cXMLElement *c
 
 InterfaceEntry *RoutingTable6::getInterfaceByAddress(const IPv6Address& addr)
 {
-    Enter_Method("getInterfaceByAddress(%s)=?", addr.str().c_str());
+    Enter_Method_Lite("getInterfaceByAddress(%s)=?", addr.str().c_str());
 
     if (addr.isUnspecified())
         return NULL;
@@ -368,7 +384,7 @@ InterfaceEntry *RoutingTable6::getInterfaceByAddress(const IPv6Address& addr)
 
 bool RoutingTable6::isLocalAddress(const IPv6Address& dest) const
 {
-    Enter_Method("isLocalAddress(%s) y/n", dest.str().c_str());
+    Enter_Method_Lite("isLocalAddress(%s) y/n", dest.str().c_str());
 
     // first, check if we have an interface with this address
     for (int i=0; i<ift->getNumInterfaces(); i++)
@@ -402,7 +418,8 @@ bool RoutingTable6::isLocalAddress(const IPv6Address& dest) const
 
 const IPv6Address& RoutingTable6::lookupDestCache(const IPv6Address& dest, int& outInterfaceId) const
 {
-    Enter_Method("lookupDestCache(%s)", dest.str().c_str());
+    // address is only formatted for the animation, not on every lookup
+    Enter_Method_Lite("lookupDestCache(%s)", dest.str().c_str());
 
     DestCache::const_iterator it = destCache.find(dest);
     if (it == destCache.end())
@@ -416,26 +433,41 @@ const IPv6Address& RoutingTable6::lookupDestCache(const IPv6Address& dest, int&
 
 const IPv6Route *RoutingTable6::doLongestPrefixMatch(const IPv6Address& dest)
 {
-    Enter_Method("doLongestPrefixMatch(%s)", dest.str().c_str());
+    Enter_Method_Lite("doLongestPrefixMatch(%s)", dest.str().c_str());
 
-    // we'll just stop at the first match, because the table is sorted
-    // by prefix lengths and metric (see addRoute())
-    for (RouteList::const_iterator it=routeList.begin(); it!=routeList.end(); it++)
+    // collect the trie nodes holding routes along the bits of dest;
+    // the last one has the longest matching prefix
+    RouteTrieNode *matches[129];
+    int numMatches = 0;
+    RouteTrieNode *node = trieRoot;
+    for (int bit=0; node; bit++)
     {
-        if (dest.matches((*it)->getDestPrefix(),(*it)->getPrefixLength()))
+        if (!node->routes.empty())
+            matches[numMatches++] = node;
+        if (bit==128)
+            break;
+        node = node->child[addressBit(dest, bit)];
+    }
+
+    // routes within a node are sorted by metric; return the first one
+    // that has not expired. Expired on-link prefixes are thrown out here,
+    // and the lookup goes on with the next candidate.
+    simtime_t now = simTime();
+    for (int i=numMatches-1; i>=0; i--)
+    {
+        RouteList& routes = matches[i]->routes;
+        for (unsigned int j=0; j<routes.size(); )
         {
-            // FIXME proofread this code, iterator invalidation-wise, etc
-            bool entryExpired = false;
-            if (simTime() > (*it)->getExpiryTime() && (*it)->getExpiryTime() != 0)//since 0 represents infinity.
-            {
-                EV << "Expired prefix detected!!" << endl;
-                removeOnLinkPrefix((*it)->getDestPrefix(), (*it)->getPrefixLength());
-                entryExpired = true;
-            }
-            if (entryExpired == false) return *it;
+            IPv6Route *route = routes[j];
+            if (route->getExpiryTime()==0 || now <= route->getExpiryTime()) // 0 represents infinity
+                return route;
+            EV << "Expired prefix detected!!" << endl;
+            if (route->getSrc()==IPv6Route::FROM_RA)
+                removeRoute(route); // also removes it from routes[]
+            else
+                j++;
         }
     }
-    // FIXME todo: if we selected an expired route, throw it out and select again!
     return NULL;
 }
 
@@ -449,9 +481,9 @@ bool RoutingTable6::isPrefixPresent(const IPv6Address& prefix) const
 
 void RoutingTable6::updateDestCache(const IPv6Address& dest, const IPv6Address& nextHopAddr, int interfaceId)
 {
-    // FIXME this performs 2 lookups -- optimize to do only one
-    destCache[dest].nextHopAddr = nextHopAddr;
-    destCache[dest].interfaceId = interfaceId;
+    DestCacheEntry& entry = destCache[dest];
+    entry.nextHopAddr = nextHopAddr;
+    entry.interfaceId = interfaceId;
 
     updateDisplayString();
 }
@@ -564,8 +596,12 @@ void RoutingTable6::removeOnLinkPrefix(const IPv6Address& destPrefix, int prefix
     {
         if ((*it)->getSrc()==IPv6Route::FROM_RA && (*it)->getDestPrefix()==destPrefix && (*it)->getPrefixLength()==prefixLength)
         {
+            IPv6Route *route = *it;
+            nb->fireChangeNotification(NF_IPv6_ROUTE_DELETED, route); // rather: going to be deleted
+            trieRemove(route);
             routeList.erase(it);
-            return; // there can be only one such route, addOrUpdateOnLinkPrefix() guarantees that
+            delete route;
+            break; // there can be only one such route, addOrUpdateOnLinkPrefix() guarantees that
         }
     }
 
@@ -617,9 +653,50 @@ bool RoutingTable6::routeLessThan(const IPv6Route *a, const IPv6Route *b)
     return a->getMetric() < b->getMetric();
 }
 
+void RoutingTable6::trieInsert(IPv6Route *route)
+{
+    const IPv6Address& prefix = route->getDestPrefix();
+    RouteTrieNode *node = trieRoot;
+    for (int bit=0; bit<route->getPrefixLength(); bit++)
+    {
+        RouteTrieNode *&child = node->child[addressBit(prefix, bit)];
+        if (!child)
+            child = new RouteTrieNode();
+        node = child;
+    }
+
+    // insert after routes with the same or better metric
+    RouteList::iterator it = node->routes.begin();
+    while (it!=node->routes.end() && (*it)->getMetric() <= route->getMetric())
+        ++it;
+    node->routes.insert(it, route);
+}
+
+void RoutingTable6::trieRemove(IPv6Route *route)
+{
+    const IPv6Address& prefix = route->getDestPrefix();
+    RouteTrieNode *node = trieRoot;
+    for (int bit=0; node && bit<route->getPrefixLength(); bit++)
+        node = node->child[addressBit(prefix, bit)];
+    ASSERT(node);
+    RouteList::iterator it = std::find(node->routes.begin(), node->routes.end(), route);
+    ASSERT(it!=node->routes.end());
+    node->routes.erase(it);
+}
+
+void RoutingTable6::deleteTrie(RouteTrieNode *node)
+{
+    if (!node)
+        return;
+    deleteTrie(node->child[0]);
+    deleteTrie(node->child[1]);
+    delete node;
+}
+
 void RoutingTable6::addRoute(IPv6Route *route)
 {
     routeList.push_back(route);
+    trieInsert(route);
 
     // we keep entries sorted by prefix length in routeList, so that we can
     // stop at the first match when doing the longest prefix matching
@@ -637,6 +714,7 @@ void RoutingTable6::removeRoute(IPv6Route *route)
 
     nb->fireChangeNotification(NF_IPv6_ROUTE_DELETED, route); // rather: going to be deleted
 
+    trieRemove(route);
     routeList.erase(it);
     delete route;
 
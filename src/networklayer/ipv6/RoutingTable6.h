@@ -21,6 +21,7 @@
 #include <vector>
 #include <omnetpp.h>
 #include "INETDefs.h"
+#include "HashMap.h"
 #include "IPv6Address.h"
 #include "IInterfaceTable.h"
 #include "NotificationBoard.h"
@@ -116,7 +117,8 @@ class INET_API RoutingTable6 : public cSimpleModule, protected INotifiable
         // more destination specific data may be added here, e.g. path MTU
     };
     friend std::ostream& operator<<(std::ostream& os, const DestCacheEntry& e);
-    typedef std::map<IPv6Address,DestCacheEntry> DestCache;
+    typedef inet_hash::unordered_map<IPv6Address,DestCacheEntry,IPv6AddressHash> DestCache;
+    friend std::ostream& operator<<(std::ostream& os, const DestCache& destCache);
     DestCache destCache;
 
     // RouteList contains local prefixes, and (for routers)
@@ -124,11 +126,27 @@ class INET_API RoutingTable6 : public cSimpleModule, protected INotifiable
     typedef std::vector<IPv6Route*> RouteList;
     RouteList routeList;
 
+    // Binary trie over the prefix bits, used for longest prefix match.
+    // A node at depth n stores the routes with prefix length n whose prefix
+    // leads to it, sorted by metric. Nodes are not freed when their routes
+    // get removed, only in the destructor.
+    struct RouteTrieNode
+    {
+        RouteTrieNode *child[2];
+        RouteList routes;
+        RouteTrieNode() {child[0] = child[1] = NULL;}
+    };
+    RouteTrieNode *trieRoot;
+
   protected:
     // internal: routes of different type can only be added via well-defined functions
     virtual void addRoute(IPv6Route *route);
     // helper for addRoute()
     static bool routeLessThan(const IPv6Route *a, const IPv6Route *b);
+    // internal: maintaining the trie (see RouteTrieNode)
+    virtual void trieInsert(IPv6Route *route);
+    virtual void trieRemove(IPv6Route *route);
+    static void deleteTrie(RouteTrieNode *node);
     // internal
     virtual void configureInterfaceForIPv6(InterfaceEntry *ie);
     /**
@@ -201,7 +219,8 @@ class INET_API RoutingTable6 : public cSimpleModule, protected INotifiable
 
     /**
      * Performs longest prefix match in the routing table and returns
-     * the resulting route, or NULL if there was no match.
+     * the resulting route, or NULL if there was no match. Expired
+     * on-link prefixes encountered during the lookup are removed.
      */
     const IPv6Route *doLongestPrefixMatch(const IPv6Address& dest);
 
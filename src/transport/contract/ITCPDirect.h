@@ -0,0 +1,93 @@
+//
+// Copyright (C) 2009 Andras Varga
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef __INET_ITCPDIRECT_H
+#define __INET_ITCPDIRECT_H
+
+#include <limits.h>
+#include <omnetpp.h>
+#include "INETDefs.h"
+
+
+/**
+ * Applications that use the direct data path of TCP receive everything
+ * TCP would otherwise send them as messages via this interface, as
+ * direct method calls. The calls are made in the context of the
+ * application module, and the application becomes the owner of the
+ * message objects passed to it.
+ *
+ * @see ITCPDirect, TCPSocket::setDirectCallback()
+ */
+class INET_API ITCPDirectCallback
+{
+  public:
+    virtual ~ITCPDirectCallback() {}
+
+    /**
+     * Data arrived on the connection. Unlike TCP_I_DATA messages, msg
+     * carries no TCPCommand control info.
+     */
+    virtual void tcpDataArrived(int connId, cPacket *msg, bool urgent) = 0;
+
+    /**
+     * Any other message TCP sends to the application (TCP_I_ESTABLISHED,
+     * TCP_I_PEER_CLOSED, TCP_I_STATUS, etc), with its usual control info.
+     * Can be passed to TCPSocket::processMessage().
+     */
+    virtual void tcpIndicationArrived(cMessage *msg) = 0;
+
+    /**
+     * The send queue of the connection has drained enough that the
+     * application may send credit more bytes. Only called after a
+     * direct send returned a credit <= 0.
+     */
+    virtual void tcpWritable(int connId, long credit) {}
+};
+
+
+/**
+ * Direct method call interface of TCP implementations, used by TCPSocket
+ * to bypass message passing between the application and TCP when they
+ * are in the same host. Message passing remains the default; see
+ * TCPSocket::setDirectCallback().
+ */
+class INET_API ITCPDirect
+{
+  public:
+    virtual ~ITCPDirect() {}
+
+    /**
+     * Requests that the connection (which may not exist yet) delivers to
+     * cb instead of sending messages. Connections accepted on a listening
+     * connection inherit its callback. sendCredit is the number of bytes
+     * the application may keep in the send queue (sent but unacknowledged
+     * data included); 0 means unlimited.
+     */
+    virtual void setDirectCallback(int appGateIndex, int connId, ITCPDirectCallback *cb, long sendCredit) = 0;
+
+    /**
+     * Equivalent of a TCP_C_SEND command, without the message and its
+     * TCPSendCommand. Returns the remaining send credit (may be negative
+     * or zero, in which case the application should wait for
+     * ITCPDirectCallback::tcpWritable()), or LONG_MAX if unlimited.
+     */
+    virtual long directSend(int appGateIndex, int connId, cPacket *msg) = 0;
+};
+
+#endif
+
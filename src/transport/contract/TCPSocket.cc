@@ -30,6 +30,9 @@ TCPSocket::TCPSocket()
     yourPtr = NULL;
 
     gateToTcp = NULL;
+    tcpDirect = NULL;
+    tcpGateIndex = -1;
+    sendCredit = LONG_MAX;
 }
 
 TCPSocket::TCPSocket(cMessage *msg)
@@ -46,6 +49,9 @@ TCPSocket::TCPSocket(cMessage *msg)
     yourPtr = NULL;
 
     gateToTcp = NULL;
+    tcpDirect = NULL;
+    tcpGateIndex = -1;
+    sendCredit = LONG_MAX;
 
     if (msg->getKind()==TCP_I_ESTABLISHED)
     {
@@ -168,6 +174,12 @@ void TCPSocket::send(cMessage *msg)
     if (sockstate!=CONNECTED && sockstate!=CONNECTING && sockstate!=PEER_CLOSED)
         opp_error("TCPSocket::send(): not connected or connecting");
 
+    if (tcpDirect)
+    {
+        sendCredit = tcpDirect->directSend(tcpGateIndex, connId, PK(msg));
+        return;
+    }
+
     msg->setKind(TCP_C_SEND);
     TCPSendCommand *cmd = new TCPSendCommand();
     cmd->setConnId(connId);
@@ -175,6 +187,23 @@ void TCPSocket::send(cMessage *msg)
     sendToTCP(msg);
 }
 
+bool TCPSocket::setDirectCallback(ITCPDirectCallback *callback, long credit)
+{
+    if (!gateToTcp)
+        opp_error("TCPSocket: setOutputGate() must be invoked before socket can be used");
+
+    cGate *tcpGate = gateToTcp->getPathEndGate();
+    ITCPDirect *tcp = dynamic_cast<ITCPDirect *>(tcpGate->getOwnerModule());
+    if (!tcp)
+        return false;
+
+    tcpDirect = tcp;
+    tcpGateIndex = tcpGate->getIndex();
+    sendCredit = credit>0 ? credit : LONG_MAX;
+    tcpDirect->setDirectCallback(tcpGateIndex, connId, callback, credit);
+    return true;
+}
+
 void TCPSocket::close()
 {
     if (sockstate!=CONNECTED && sockstate!=PEER_CLOSED && sockstate!=CONNECTING && sockstate!=LISTENING)
@@ -215,6 +244,8 @@ void TCPSocket::renewSocket()
     connId = ev.getUniqueNumber();
     remoteAddr = localAddr = IPvXAddress();
     remotePrt = localPrt = -1;
+    tcpDirect = NULL;
+    sendCredit = LONG_MAX;
 
     sockstate = NOT_BOUND;
 }
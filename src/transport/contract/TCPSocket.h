@@ -22,6 +22,7 @@
 #include <omnetpp.h>
 #include "TCPCommand_m.h"
 #include "IPvXAddress.h"
+#include "ITCPDirect.h"
 
 class TCPStatusInfo;
 
@@ -158,6 +159,9 @@ class INET_API TCPSocket
     void *yourPtr;
 
     cGate *gateToTcp;
+    ITCPDirect *tcpDirect;  // non-NULL if the direct data path is in use
+    int tcpGateIndex;       // our gate index at the TCP module, for tcpDirect
+    long sendCredit;        // as last returned by tcpDirect
 
     std::string sendQueueClass;
     std::string receiveQueueClass;
@@ -295,10 +299,41 @@ class INET_API TCPSocket
     void connect(IPvXAddress remoteAddr, int remotePort);
 
     /**
-     * Sends data packet.
+     * Sends data packet. With the direct data path (see setDirectCallback()),
+     * the packet is passed to TCP in a direct method call.
      */
     void send(cMessage *msg);
 
+    /**
+     * Switches the socket to the direct data path: TCP will pass data and
+     * indications of this connection to cb in direct method calls instead
+     * of sending messages, and send() will pass data to TCP the same way.
+     * For a listening socket, connections accepted on it also deliver to cb.
+     * Should be called before connect() or listen(), and after renewSocket().
+     *
+     * sendCredit limits the bytes the connection may hold in its send queue
+     * (0 means unlimited); see getSendCredit() and
+     * ITCPDirectCallback::tcpWritable().
+     *
+     * Returns false, and leaves the socket using messages, if the module
+     * at the other end of the output gate does not support direct calls
+     * (it is not a TCP in the same host, or its TCP implementation lacks
+     * ITCPDirect).
+     */
+    bool setDirectCallback(ITCPDirectCallback *cb, long sendCredit=0);
+
+    /**
+     * Returns true if the socket uses the direct data path.
+     */
+    bool isDirect() const {return tcpDirect!=NULL;}
+
+    /**
+     * Returns the send credit returned by TCP on the last send() on the
+     * direct data path (LONG_MAX if unlimited). If it is not positive,
+     * the application should wait for ITCPDirectCallback::tcpWritable().
+     */
+    long getSendCredit() const {return sendCredit;}
+
     /**
      * Closes the local end of the connection. With TCP, a CLOSE operation
      * means "I have no more data to send", and thus results in a one-way
@@ -20,9 +20,9 @@
 #define __INET_TCPSOCKETMAP_H
 
 
-#include <map>
 #include <omnetpp.h>
 #include "TCPSocket.h"
+#include "HashMap.h"
 
 
 /**
@@ -32,7 +32,7 @@
 class INET_API TCPSocketMap
 {
   protected:
-    typedef std::map<int,TCPSocket*> SocketMap;
+    typedef inet_hash::unordered_map<int,TCPSocket*> SocketMap;  // connId -> socket
     SocketMap socketMap;
   public:
     /**
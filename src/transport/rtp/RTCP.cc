@@ -254,7 +254,7 @@ void RTCP::chooseSSRC(){
     } while (ssrcConflict);
     ev << "chooseSSRC" << ssrc;
     _senderInfo->setSSRC(ssrc);
-    _participantInfos->add(_senderInfo);
+    addParticipantInfo(_senderInfo);
     _ssrcChosen = true;
 }
 
@@ -291,7 +291,8 @@ void RTCP::createPacket()
             participantInfo->nextInterval(simTime());
 
             if (participantInfo->toBeDeleted(simTime())) {
-                _participantInfos->remove(participantInfo);
+                _participantsBySSRC.erase(participantInfo->getSSRC());
+                _participantInfos->remove(i);
                 delete participantInfo;
                 // perhaps inform the profile
             }
@@ -350,7 +351,7 @@ void RTCP::processIncomingRTPPacket(RTPPacket *packet, IPAddress address, int po
         participantInfo = new RTPParticipantInfo(ssrc);
         participantInfo->setAddress(address);
         participantInfo->setRTPPort(port);
-        _participantInfos->add(participantInfo);
+        addParticipantInfo(participantInfo);
     }
     else {
         // check for ssrc conflict
@@ -389,7 +390,7 @@ void RTCP::processIncomingRTCPPacket(RTCPCompoundPacket *packet, IPAddress addre
                     participantInfo = new RTPReceiverInfo(ssrc);
                     participantInfo->setAddress(address);
                     participantInfo->setRTCPPort(port);
-                    _participantInfos->add(participantInfo);
+                    addParticipantInfo(participantInfo);
                 }
                 else {
                     if (participantInfo->getAddress() == address) {
@@ -431,7 +432,7 @@ void RTCP::processIncomingRTCPPacket(RTCPCompoundPacket *packet, IPAddress addre
                     participantInfo = new RTPReceiverInfo(ssrc);
                     participantInfo->setAddress(address);
                     participantInfo->setRTCPPort(port);
-                    _participantInfos->add(participantInfo);
+                    addParticipantInfo(participantInfo);
                 }
                 else {
                     if (participantInfo->getAddress() == address) {
@@ -481,7 +482,7 @@ void RTCP::processIncomingRTCPPacket(RTCPCompoundPacket *packet, IPAddress addre
                             participantInfo = new RTPReceiverInfo(ssrc);
                             participantInfo->setAddress(address);
                             participantInfo->setRTCPPort(port);
-                            _participantInfos->add(participantInfo);
+                            addParticipantInfo(participantInfo);
                         }
                         else {
                             // check for ssrc conflict
@@ -498,7 +499,7 @@ void RTCP::processIncomingRTCPPacket(RTCPCompoundPacket *packet, IPAddress addre
                 RTPParticipantInfo *participantInfo = findParticipantInfo(ssrc);
 
                 if (participantInfo != NULL && participantInfo != _senderInfo) {
-                    _participantInfos->remove(participantInfo);
+                    removeParticipantInfo(participantInfo);
 
                     delete participantInfo;
                     // perhaps it would be useful to inform
@@ -518,14 +519,22 @@ void RTCP::processIncomingRTCPPacket(RTCPCompoundPacket *packet, IPAddress addre
 
 RTPParticipantInfo *RTCP::findParticipantInfo(uint32 ssrc)
 {
-    char *ssrcString = RTPParticipantInfo::ssrcToName(ssrc);
-    int participantIndex = _participantInfos->find(ssrcString);
-    if (participantIndex != -1) {
-        return (RTPParticipantInfo *)(_participantInfos->get(participantIndex));
-    }
-    else {
-        return NULL;
-    }
+    ParticipantMap::iterator it = _participantsBySSRC.find(ssrc);
+    return it != _participantsBySSRC.end() ? it->second : NULL;
+}
+
+
+void RTCP::addParticipantInfo(RTPParticipantInfo *participantInfo)
+{
+    _participantInfos->add(participantInfo);
+    _participantsBySSRC[participantInfo->getSSRC()] = participantInfo;
+}
+
+
+void RTCP::removeParticipantInfo(RTPParticipantInfo *participantInfo)
+{
+    _participantsBySSRC.erase(participantInfo->getSSRC());
+    _participantInfos->remove(participantInfo);
 }
 
 
@@ -23,6 +23,7 @@
 #define __INET_RTCPENDSYSTEMMODULE_H
 
 #include "INETDefs.h"
+#include "HashMap.h"
 #include "IPAddress.h"
 #include "RTPInnerPacket.h"
 #include "RTPParticipantInfo.h"
@@ -153,6 +154,12 @@ class INET_API RTCP : public cSimpleModule
          */
         cArray *_participantInfos;
 
+        /**
+         * Index of _participantInfos by ssrc identifier.
+         */
+        typedef inet_hash::unordered_map<uint32, RTPParticipantInfo *> ParticipantMap;
+        ParticipantMap _participantsBySSRC;
+
         /**
          * The server socket for receiving rtcp packets.
          */
@@ -224,6 +231,18 @@ class INET_API RTCP : public cSimpleModule
          */
         virtual RTPParticipantInfo* findParticipantInfo(uint32 ssrc);
 
+        /**
+         * Adds the RTPParticipantInfo to _participantInfos and to the
+         * ssrc index. Its ssrc identifier must already be set.
+         */
+        virtual void addParticipantInfo(RTPParticipantInfo *participantInfo);
+
+        /**
+         * Removes the RTPParticipantInfo from _participantInfos and from
+         * the ssrc index, without deleting it.
+         */
+        virtual void removeParticipantInfo(RTPParticipantInfo *participantInfo);
+
         /**
          * Recalculates the average size of an RTCPCompoundPacket when
          * one of this size has been sent or received.
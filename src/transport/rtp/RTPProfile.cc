@@ -278,8 +278,9 @@ void RTPProfile::processOutgoingPacket(RTPInnerPacket *rinp)
 
 RTPProfile::SSRCGate *RTPProfile::findSSRCGate(uint32 ssrc)
 {
-    const char *name = RTPParticipantInfo::ssrcToName(ssrc);
+    char *name = RTPParticipantInfo::ssrcToName(ssrc);
     int objectIndex = _ssrcGates->find(name);
+    delete [] name;
     if (objectIndex == -1) {
         return NULL;
     }
@@ -106,6 +106,7 @@ void SCTP::initialize()
     numPacketsReceived = 0;
     numPacketsDropped    = 0;
     sizeConnMap          = 0;
+    connStatRecorder.configure(par("recordStats"), par("vectorSamplingRatio"), par("statsSummary"));
     if ((bool)par("udpEncapsEnabled"))
         bindPortForUDP();
 }
@@ -889,4 +890,5 @@ void SCTP::finish()
         recordScalar("Packets Dropped",      numPacketsDropped);
 
     }
+    connStatRecorder.recordSummaries();
 }
@@ -27,6 +27,7 @@
 #include <map>
 #include "IPvXAddress.h"
 #include "UDPSocket.h"
+#include "ConnStatVector.h"
 
 
 class SCTPAssociation;
@@ -190,6 +191,8 @@ class INET_API SCTP : public cSimpleModule
         uint32 numPacketsDropped;
         //double failover();
     public:
+        ConnStatRecorder connStatRecorder;  // decides which association statistics get recorded
+
         //Module_Class_Members(SCTP, cSimpleModule, 0);
         virtual ~SCTP();
         virtual void initialize();
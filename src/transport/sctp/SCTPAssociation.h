@@ -269,16 +269,16 @@ class INET_API SCTPPathVariables : public cPolymorphic
         unsigned int        numberOfHeartbeatAcksRcvd;
 
         // ====== Output Vectors ==============================================
-        cOutVector*         pathTSN;
-        cOutVector*         pathRcvdTSN;
-        cOutVector*         pathHb;
-        cOutVector*         pathRcvdHb;
-        cOutVector*         pathHbAck;
-        cOutVector*         pathRcvdHbAck;
-        cOutVector*         statisticsPathRTO;
-        cOutVector*         statisticsPathRTT;
-        cOutVector*         statisticsPathSSthresh;
-        cOutVector*         statisticsPathCwnd;
+        ConnStatVector*         pathTSN;
+        ConnStatVector*         pathRcvdTSN;
+        ConnStatVector*         pathHb;
+        ConnStatVector*         pathRcvdHb;
+        ConnStatVector*         pathHbAck;
+        ConnStatVector*         pathRcvdHbAck;
+        ConnStatVector*         statisticsPathRTO;
+        ConnStatVector*         statisticsPathRTT;
+        ConnStatVector*         statisticsPathSSthresh;
+        ConnStatVector*         statisticsPathCwnd;
 };
 
 
@@ -552,16 +552,17 @@ class INET_API SCTPAssociation : public cObject
         CCFunctions             ccFunctions;
         uint16                  ccModule;
 
-        cOutVector*             advRwnd;
-        cOutVector*             cumTsnAck;
-        cOutVector*             sendQueue;
-        cOutVector*             numGapBlocks;
+        ConnStatVector*             advRwnd;
+        ConnStatVector*             cumTsnAck;
+        ConnStatVector*             sendQueue;
+        ConnStatVector*             numGapBlocks;
 
         // Variables associated with the state of this association
         SCTPStateVariables*     state;
         BytesToBeSent           bytes;
         SCTP*                   sctpMain;                   // SCTP module
         cFSM*                   fsm;                            // SCTP state machine
+        bool                    recordVectors;              // selected for output vector recording, see ConnStatRecorder
         SCTPPathMap             sctpPathMap;
         QueueCounter            qCounter;
         SCTPQueue*              transmissionQ;
@@ -596,6 +597,7 @@ class INET_API SCTPAssociation : public cObject
         inline SCTPQueue* getRetransmissionQueue() const { return retransmissionQ; };
         inline SCTPAlgorithm* getSctpAlgorithm() const { return sctpAlgorithm; };
         inline SCTP* getSctpMain() const { return sctpMain; };
+        inline bool isRecordingVectors() const { return recordVectors; };
         inline cFSM* getFsm() const { return fsm; };
         inline cMessage* getInitTimer() const { return T1_InitTimer; };
         inline cMessage* getShutdownTimer() const { return T2_ShutdownTimer; };
@@ -94,29 +94,32 @@ SCTPPathVariables::SCTPPathVariables(const IPvXAddress& addr, SCTPAssociation* a
     CwndTimer->setContextPointer(association);
     T3_RtxTimer->setContextPointer(association);
 
+    // statistics (created only as required by the SCTP module's recording policy)
+    ConnStatRecorder& stats = assoc->getSctpMain()->connStatRecorder;
+    bool recordVectors = assoc->isRecordingVectors();
     snprintf(str, sizeof(str), "RTO %d:%s",assoc->assocId,addr.str().c_str());
-    statisticsPathRTO = new cOutVector(str);
+    statisticsPathRTO = stats.createVector(str, recordVectors, "RTO");
     snprintf(str, sizeof(str), "RTT %d:%s",assoc->assocId,addr.str().c_str());
-    statisticsPathRTT = new cOutVector(str);
+    statisticsPathRTT = stats.createVector(str, recordVectors, "RTT");
 
     snprintf(str, sizeof(str), "Slow Start Threshold %d:%s",assoc->assocId,addr.str().c_str());
-    statisticsPathSSthresh = new cOutVector(str);
+    statisticsPathSSthresh = stats.createVector(str, recordVectors, "Slow Start Threshold");
     snprintf(str, sizeof(str), "Congestion Window %d:%s",assoc->assocId,addr.str().c_str());
-    statisticsPathCwnd = new cOutVector(str);
+    statisticsPathCwnd = stats.createVector(str, recordVectors, "Congestion Window");
 
     snprintf(str, sizeof(str), "TSN Sent %d:%s",assoc->assocId,addr.str().c_str());
-    pathTSN = new cOutVector(str);
+    pathTSN = stats.createVector(str, recordVectors, "TSN Sent");
     snprintf(str, sizeof(str), "TSN Received %d:%s",assoc->assocId,addr.str().c_str());
-    pathRcvdTSN = new cOutVector(str);
+    pathRcvdTSN = stats.createVector(str, recordVectors, "TSN Received");
 
     snprintf(str, sizeof(str), "HB Sent %d:%s",assoc->assocId,addr.str().c_str());
-    pathHb = new cOutVector(str);
+    pathHb = stats.createVector(str, recordVectors, "HB Sent");
     snprintf(str, sizeof(str), "HB ACK Sent %d:%s",assoc->assocId,addr.str().c_str());
-    pathHbAck = new cOutVector(str);
+    pathHbAck = stats.createVector(str, recordVectors, "HB ACK Sent");
     snprintf(str, sizeof(str), "HB Received %d:%s",assoc->assocId,addr.str().c_str());
-    pathRcvdHb = new cOutVector(str);
+    pathRcvdHb = stats.createVector(str, recordVectors, "HB Received");
     snprintf(str, sizeof(str), "HB ACK Received %d:%s",assoc->assocId,addr.str().c_str());
-    pathRcvdHbAck = new cOutVector(str);
+    pathRcvdHbAck = stats.createVector(str, recordVectors, "HB ACK Received");
 
 
 
@@ -131,12 +134,12 @@ SCTPPathVariables::SCTPPathVariables(const IPvXAddress& addr, SCTPAssociation* a
 
 SCTPPathVariables::~SCTPPathVariables()
 {
-    statisticsPathSSthresh->record(0);
-    statisticsPathCwnd->record(0);
+    if (statisticsPathSSthresh) statisticsPathSSthresh->record(0);
+    if (statisticsPathCwnd) statisticsPathCwnd->record(0);
     delete statisticsPathSSthresh;
     delete statisticsPathCwnd;
-    statisticsPathRTO->record(0);
-    statisticsPathRTT->record(0);
+    if (statisticsPathRTO) statisticsPathRTO->record(0);
+    if (statisticsPathRTT) statisticsPathRTT->record(0);
     delete statisticsPathRTO;
     delete statisticsPathRTT;
 
@@ -353,7 +356,8 @@ SCTPAssociation::SCTPAssociation(SCTP* _module, int32 _appGateIndex, int32 _asso
     // ====== Output vectors =================================================
     char vectorName[128];
     snprintf(vectorName, sizeof(vectorName), "Advertised Receiver Window %d", assocId);
-    advRwnd = new cOutVector(vectorName);
+    recordVectors = sctpMain->connStatRecorder.selectConnection();
+    advRwnd = sctpMain->connStatRecorder.createVector(vectorName, recordVectors, "Advertised Receiver Window");
 
     // ====== Stream scheduling ==============================================
     ssModule = sctpMain->par("ssModule");
@@ -724,11 +728,11 @@ void SCTPAssociation::stateEntered(int32 status)
             sendEstabIndicationToApp();
             char str[128];
             snprintf(str, sizeof(str), "Cumulated TSN Ack of Association %d", assocId);
-            cumTsnAck = new cOutVector(str);
+            cumTsnAck = sctpMain->connStatRecorder.createVector(str, recordVectors, "Cumulated TSN Ack of Association");
             snprintf(str, sizeof(str), "Number of Gap Blocks in Last SACK of Association %d", assocId);
-            numGapBlocks = new cOutVector(str);
+            numGapBlocks = sctpMain->connStatRecorder.createVector(str, recordVectors, "Number of Gap Blocks in Last SACK of Association");
             snprintf(str, sizeof(str), "SendQueue of Association %d", assocId);
-            sendQueue = new cOutVector(str);
+            sendQueue = sctpMain->connStatRecorder.createVector(str, recordVectors, "SendQueue of Association");
             state->sendQueueLimit = (uint32)sctpMain->par("sendQueueLimit");
             SCTP::VTagPair vtagPair;
             vtagPair.peerVTag     = peerVTag;
@@ -192,7 +192,7 @@ void SCTPAssociation::process_SEND(SCTPEventCode& event, SCTPCommand* sctpComman
         sendIndicationToApp(SCTP_I_SENDQUEUE_FULL);
         state->appSendAllowed = false;
      }
-     sendQueue->record(stream->getStreamQ()->getLength());
+     if (sendQueue) sendQueue->record(stream->getStreamQ()->getLength());
   }
 
   state->queuedMessages++;
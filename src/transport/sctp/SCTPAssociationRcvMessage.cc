@@ -225,7 +225,7 @@ bool SCTPAssociation::process_RCV_Message(SCTPMessage*       sctpmsg,
             delete heartbeatChunk;
             if (path) {
                 path->numberOfHeartbeatsRcvd++;
-                path->pathRcvdHb->record(path->numberOfHeartbeatsRcvd);
+                if (path->pathRcvdHb) path->pathRcvdHb->record(path->numberOfHeartbeatsRcvd);
             }
             break;
         case HEARTBEAT_ACK:
@@ -1250,7 +1250,7 @@ SCTPEventCode SCTPAssociation::processDataArrived(SCTPDataChunk* dataChunk)
     state->lastDataSourceAddress = remoteAddr;
 
     sctpEV3 << simTime() << " SCTPAssociation::processDataArrived TSN=" << tsn << endl;
-    path->pathRcvdTSN->record(tsn);
+    if (path->pathRcvdTSN) path->pathRcvdTSN->record(tsn);
 
     SCTPSimpleMessage* smsg = check_and_cast <SCTPSimpleMessage*>(dataChunk->decapsulate());
     dataChunk->setBitLength(SCTP_DATA_CHUNK_LENGTH*8);
@@ -1353,7 +1353,7 @@ SCTPEventCode SCTPAssociation::processHeartbeatAckArrived(SCTPHeartbeatAckChunk*
                                                                              SCTPPathVariables*     path)
 {
     path->numberOfHeartbeatAcksRcvd++;
-    path->pathRcvdHbAck->record(path->numberOfHeartbeatAcksRcvd);
+    if (path->pathRcvdHbAck) path->pathRcvdHbAck->record(path->numberOfHeartbeatAcksRcvd);
     /* hb-ack goes to pathmanagement, reset error counters, stop timeout timer */
     const IPvXAddress addr          = hback->getRemoteAddr();
     const simtime_t hbTimeField = hback->getTimeField();
@@ -1476,7 +1476,7 @@ void SCTPAssociation::process_TIMEOUT_HEARTBEAT(SCTPPathVariables* path)
 
     /* RTO must be doubled for this path ! */
     path->pathRto = (simtime_t)min(2 * path->pathRto.dbl(), sctpMain->par("rtoMax"));
-    path->statisticsPathRTO->record(path->pathRto);
+    if (path->statisticsPathRTO) path->statisticsPathRTO->record(path->pathRto);
     /* check if any thresholds are exceeded, and if so, check if ULP must be notified */
     if (state->errorCount > (uint32)sctpMain->par("assocMaxRetrans"))
     {
@@ -1591,7 +1591,7 @@ int32 SCTPAssociation::process_TIMEOUT_RTX(SCTPPathVariables* path)
 
     // ====== Increase the RTO (by doubling it) ==============================
     path->pathRto = min(2 * path->pathRto.dbl(), sctpMain->par("rtoMax"));
-    path->statisticsPathRTO->record(path->pathRto);
+    if (path->statisticsPathRTO) path->statisticsPathRTO->record(path->pathRto);
     sctpEV3 << "Schedule T3 based retransmission for path "<< path->remoteAddress << endl;
 
     // ====== Update congestion window =======================================
@@ -200,13 +200,13 @@ void SCTPAssociation::recordInPathVectors(SCTPMessage* pMsg,
         const SCTPChunk* p_chunk = check_and_cast<const SCTPChunk *>(pMsg->getChunks(i));
         if (p_chunk->getChunkType() == DATA) {
             const SCTPDataChunk* p_data_chunk = check_and_cast<const SCTPDataChunk *>(p_chunk);
-            p_path->pathTSN->record(p_data_chunk->getTsn());
+            if (p_path->pathTSN) p_path->pathTSN->record(p_data_chunk->getTsn());
         } else if (p_chunk->getChunkType() == HEARTBEAT) {
             p_path->numberOfHeartbeatsSent++;
-            p_path->pathHb->record(p_path->numberOfHeartbeatsSent);
+            if (p_path->pathHb) p_path->pathHb->record(p_path->numberOfHeartbeatsSent);
         } else if (p_chunk->getChunkType() == HEARTBEAT_ACK) {
             p_path->numberOfHeartbeatAcksSent++;
-            p_path->pathHbAck->record(p_path->numberOfHeartbeatAcksSent);
+            if (p_path->pathHbAck) p_path->pathHbAck->record(p_path->numberOfHeartbeatAcksSent);
         }
     }
 }
@@ -903,7 +903,7 @@ SCTPSackChunk* SCTPAssociation::createSack()
         arwnd = state->localRwnd - state->queuedReceivedBytes;
         sctpEV3<<simTime()<<" arwnd = "<<state->localRwnd<<" - "<<state->queuedReceivedBytes<<" = "<<arwnd<<"\n";
     }
-    advRwnd->record(arwnd);
+    if (advRwnd) advRwnd->record(arwnd);
     SCTPSackChunk* sackChunk=new SCTPSackChunk("SACK");
     sackChunk->setChunkType(SACK);
     sackChunk->setCumTsnAck(state->cTsnAck);
@@ -1791,7 +1791,7 @@ SCTPDataMsg* SCTPAssociation::dequeueOutboundDataMsg(const int32 availableSpace,
                         state->appSendAllowed = true;
                         sendIndicationToApp(SCTP_I_SENDQUEUE_ABATED);
                     }*/
-                    sendQueue->record(streamQ->getLength());
+                    if (sendQueue) sendQueue->record(streamQ->getLength());
 
                     if (!datMsg->getFragment())
                     {
@@ -1991,7 +1991,7 @@ void SCTPAssociation::pmStartPathManagement()
              sendHeartbeat(path);
              startTimer(path->HeartbeatTimer, path->heartbeatTimeout);
              startTimer(path->HeartbeatIntervalTimer, path->heartbeatIntervalTimeout);
-        path->statisticsPathRTO->record(path->pathRto);
+        if (path->statisticsPathRTO) path->statisticsPathRTO->record(path->pathRto);
         i++;
     }
 }
@@ -2065,8 +2065,8 @@ void SCTPAssociation::pmRttMeasurement(SCTPPathVariables* path,
             // RFC 2960, sect. 6.3.1: new RTT measurements SHOULD be made no more
             //                                than once per round-trip.
             path->updateTime = simTime() + path->srtt;
-            path->statisticsPathRTO->record(path->pathRto);
-            path->statisticsPathRTT->record(rttEstimation);
+            if (path->statisticsPathRTO) path->statisticsPathRTO->record(path->pathRto);
+            if (path->statisticsPathRTT) path->statisticsPathRTT->record(rttEstimation);
         }
     }
 }
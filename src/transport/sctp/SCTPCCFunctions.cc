@@ -29,8 +29,8 @@ inline double rint(double x) {return floor(x+.5);}
 
 void SCTPAssociation::recordCwndUpdate(SCTPPathVariables* path)
 {
-    path->statisticsPathSSthresh->record(path->ssthresh);
-    path->statisticsPathCwnd->record(path->cwnd);
+    if (path->statisticsPathSSthresh) path->statisticsPathSSthresh->record(path->ssthresh);
+    if (path->statisticsPathCwnd) path->statisticsPathCwnd->record(path->cwnd);
 }
 
 
@@ -64,6 +64,7 @@ void TCP::initialize()
     WATCH_PTRMAP(tcpAppConnMap);
 
     recordStatistics = par("recordStats");
+    connStatRecorder.configure(recordStatistics, par("vectorSamplingRatio"), par("statsSummary"));
 
     cModule *netw = simulation.getSystemModule();
     testing = netw->hasPar("testing") && netw->par("testing").boolValue();
@@ -78,6 +79,8 @@ TCP::~TCP()
         delete (*i).second;
         tcpAppConnMap.erase(i);
     }
+    for (std::deque<DirectDelivery>::iterator i = directDeliveries.begin(); i!=directDeliveries.end(); ++i)
+        delete i->msg;
 }
 
 void TCP::handleMessage(cMessage *msg)
@@ -155,6 +158,14 @@ void TCP::handleMessage(cMessage *msg)
             key.connId = connId;
             tcpAppConnMap[key] = conn;
 
+            // direct data path requested by the app before the OPEN command?
+            DirectCallbackMap::iterator it = pendingDirectCallbacks.find(key);
+            if (it!=pendingDirectCallbacks.end())
+            {
+                conn->setDirectCallback(it->second.cb, it->second.sendCredit);
+                pendingDirectCallbacks.erase(it);
+            }
+
             tcpEV << "TCP connection created for " << msg << "\n";
         }
         bool ret = conn->processAppCommand(msg);
@@ -162,10 +173,105 @@ void TCP::handleMessage(cMessage *msg)
             removeConnection(conn);
     }
 
+    if (!directDeliveries.empty())
+        dispatchDirectDeliveries();
+
     if (ev.isGUI())
         updateDisplayString();
 }
 
+void TCP::setDirectCallback(int appGateIndex, int connId, ITCPDirectCallback *cb, long sendCredit)
+{
+    Enter_Method_Silent();
+
+    TCPConnection *conn = findConnForApp(appGateIndex, connId);
+    if (conn)
+    {
+        conn->setDirectCallback(cb, sendCredit);
+    }
+    else
+    {
+        // the connection will be created when the OPEN command arrives
+        AppConnKey key;
+        key.appGateIndex = appGateIndex;
+        key.connId = connId;
+        DirectCallbackEntry& entry = pendingDirectCallbacks[key];
+        entry.cb = cb;
+        entry.sendCredit = sendCredit;
+    }
+}
+
+long TCP::directSend(int appGateIndex, int connId, cPacket *msg)
+{
+    Enter_Method_Silent();
+    take(msg);
+
+    TCPConnection *conn = findConnForApp(appGateIndex, connId);
+    if (!conn)
+        error("directSend(): no connection with appGateIndex=%d connId=%d", appGateIndex, connId);
+
+    bool ret = conn->processDirectSend(msg);
+    long credit = ret ? conn->getDirectSendCredit() : 0;
+    if (!ret)
+        removeConnection(conn);
+
+    if (!directDeliveries.empty())
+        dispatchDirectDeliveries();
+    return credit;
+}
+
+void TCP::sendToAppDirect(TCPConnection *conn, ITCPDirectCallback *cb, cMessage *msg)
+{
+    DirectDelivery d;
+    d.cb = cb;
+    d.appGateIndex = conn->appGateIndex;
+    d.connId = conn->connId;
+    d.msg = msg;
+    d.credit = 0;
+    directDeliveries.push_back(d);
+}
+
+void TCP::notifyWritableDirect(TCPConnection *conn, ITCPDirectCallback *cb, long credit)
+{
+    DirectDelivery d;
+    d.cb = cb;
+    d.appGateIndex = conn->appGateIndex;
+    d.connId = conn->connId;
+    d.msg = NULL;
+    d.credit = credit;
+    directDeliveries.push_back(d);
+}
+
+void TCP::dispatchDirectDeliveries()
+{
+    // callbacks may call directSend(), which would get us here again;
+    // the outermost call delivers everything, in order
+    if (dispatchingDirect)
+        return;
+    dispatchingDirect = true;
+    while (!directDeliveries.empty())
+    {
+        DirectDelivery d = directDeliveries.front();
+        directDeliveries.pop_front();
+
+        // switch to the app's context, and hand over the message to it
+        cModule *app = gate("appOut", d.appGateIndex)->getPathEndGate()->getOwnerModule();
+        cContextSwitcher tmp(app);
+        if (!d.msg)
+            d.cb->tcpWritable(d.connId, d.credit);
+        else
+        {
+            drop(d.msg);
+            int kind = d.msg->getKind();
+            if (kind==TCP_I_DATA || kind==TCP_I_URGENT_DATA)
+                d.cb->tcpDataArrived(d.connId, PK(d.msg), kind==TCP_I_URGENT_DATA);
+            else
+                d.cb->tcpIndicationArrived(d.msg);
+        }
+    }
+    dispatchingDirect = false;
+}
+
 TCPConnection *TCP::createConnection(int appGateIndex, int connId)
 {
     return new TCPConnection(this, appGateIndex, connId);
@@ -404,4 +510,5 @@ void TCP::removeConnection(TCPConnection *conn)
 void TCP::finish()
 {
     tcpEV << getFullPath() << ": finishing with " << tcpConnMap.size() << " connections open.\n";
+    connStatRecorder.recordSummaries();
 }
@@ -20,8 +20,11 @@
 
 #include <map>
 #include <set>
+#include <deque>
 #include <omnetpp.h>
 #include "IPvXAddress.h"
+#include "ConnStatVector.h"
+#include "ITCPDirect.h"
 
 
 class TCPConnection;
@@ -93,7 +96,7 @@ class TCPSegment;
  * The concrete TCPAlgorithm class to use can be chosen per connection (in OPEN)
  * or in a module parameter.
  */
-class INET_API TCP : public cSimpleModule
+class INET_API TCP : public cSimpleModule, public ITCPDirect
 {
   public:
     struct AppConnKey  // XXX this class is redundant since connId is already globally unique
@@ -140,6 +143,26 @@ class INET_API TCP : public cSimpleModule
     ushort lastEphemeralPort;
     std::multiset<ushort> usedEphemeralPorts;
 
+    // direct data path (ITCPDirect): callbacks registered for connections
+    // that do not exist yet, and deliveries waiting to be dispatched
+    struct DirectCallbackEntry
+    {
+        ITCPDirectCallback *cb;
+        long sendCredit;
+    };
+    struct DirectDelivery
+    {
+        ITCPDirectCallback *cb;
+        int appGateIndex;
+        int connId;
+        cMessage *msg;  // NULL for tcpWritable()
+        long credit;
+    };
+    typedef std::map<AppConnKey,DirectCallbackEntry> DirectCallbackMap;
+    DirectCallbackMap pendingDirectCallbacks;
+    std::deque<DirectDelivery> directDeliveries;
+    bool dispatchingDirect;
+
   protected:
     /** Factory method; may be overriden for customizing TCP */
     virtual TCPConnection *createConnection(int appGateIndex, int connId);
@@ -150,15 +173,17 @@ class INET_API TCP : public cSimpleModule
     virtual void segmentArrivalWhileClosed(TCPSegment *tcpseg, IPvXAddress src, IPvXAddress dest);
     virtual void removeConnection(TCPConnection *conn);
     virtual void updateDisplayString();
+    virtual void dispatchDirectDeliveries();
 
   public:
     static bool testing;    // switches between tcpEV and testingEV
     static bool logverbose; // if !testing, turns on more verbose logging
 
     bool recordStatistics;  // output vectors on/off
+    ConnStatRecorder connStatRecorder; // decides which connections record which statistics
 
   public:
-    TCP() {}
+    TCP() {dispatchingDirect = false;}
     virtual ~TCP();
 
   protected:
@@ -189,6 +214,27 @@ class INET_API TCP : public cSimpleModule
      * To be called from TCPConnection: reserves an ephemeral port for the connection.
      */
     virtual ushort getEphemeralPort();
+
+    /** @name ITCPDirect methods */
+    //@{
+    virtual void setDirectCallback(int appGateIndex, int connId, ITCPDirectCallback *cb, long sendCredit);
+    virtual long directSend(int appGateIndex, int connId, cPacket *msg);
+    //@}
+
+    /**
+     * To be called from TCPConnection instead of sending msg to the app, if
+     * the connection has a direct callback. Delivery is deferred until
+     * TCP has finished processing the current event, so that the app can
+     * safely call back into TCP (e.g. send a reply).
+     */
+    virtual void sendToAppDirect(TCPConnection *conn, ITCPDirectCallback *cb, cMessage *msg);
+
+    /**
+     * To be called from TCPConnection when its send queue has drained
+     * enough for the app to send credit bytes again. Deferred like
+     * sendToAppDirect().
+     */
+    virtual void notifyWritableDirect(TCPConnection *conn, ITCPDirectCallback *cb, long credit);
 };
 
 #endif
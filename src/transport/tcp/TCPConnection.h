@@ -343,25 +343,31 @@ class INET_API TCPConnection
     cMessage *finWait2Timer;
     cMessage *synRexmitTimer; // for retransmitting SYN and SYN+ACK
 
+    // direct data path, see ITCPDirect
+    ITCPDirectCallback *directCallback; // NULL if the app uses messages
+    long directSendCredit;              // send queue limit for the app, 0 if unlimited
+    bool directWritableWanted;          // app ran out of credit, wants tcpWritable()
+
     // statistics
-    cOutVector *sndWndVector;   // snd_wnd
-    cOutVector *rcvWndVector;   // rcv_wnd
-    cOutVector *rcvAdvVector;   // current advertised window (=rcv_avd)
-    cOutVector *sndNxtVector;   // sent seqNo
-    cOutVector *sndAckVector;   // sent ackNo
-    cOutVector *rcvSeqVector;   // received seqNo
-    cOutVector *rcvAckVector;   // received ackNo (= snd_una)
-    cOutVector *unackedVector;  // number of bytes unacknowledged
-
-    cOutVector *dupAcksVector;   // current number of received dupAcks
-    cOutVector *pipeVector;      // current sender's estimate of bytes outstanding in the network
-    cOutVector *sndSacksVector;  // number of sent Sacks
-    cOutVector *rcvSacksVector;  // number of received Sacks
-    cOutVector *rcvOooSegVector; // number of received out-of-order segments
-
-    cOutVector *sackedBytesVector;        // current number of received sacked bytes
-    cOutVector *tcpRcvQueueBytesVector;   // current amount of used bytes in tcp receive queue
-    cOutVector *tcpRcvQueueDropsVector;   // number of drops in tcp receive queue
+    bool recordVectors;           // whether this connection was selected for output vector recording
+    ConnStatVector *sndWndVector;   // snd_wnd
+    ConnStatVector *rcvWndVector;   // rcv_wnd
+    ConnStatVector *rcvAdvVector;   // current advertised window (=rcv_avd)
+    ConnStatVector *sndNxtVector;   // sent seqNo
+    ConnStatVector *sndAckVector;   // sent ackNo
+    ConnStatVector *rcvSeqVector;   // received seqNo
+    ConnStatVector *rcvAckVector;   // received ackNo (= snd_una)
+    ConnStatVector *unackedVector;  // number of bytes unacknowledged
+
+    ConnStatVector *dupAcksVector;   // current number of received dupAcks
+    ConnStatVector *pipeVector;      // current sender's estimate of bytes outstanding in the network
+    ConnStatVector *sndSacksVector;  // number of sent Sacks
+    ConnStatVector *rcvSacksVector;  // number of received Sacks
+    ConnStatVector *rcvOooSegVector; // number of received out-of-order segments
+
+    ConnStatVector *sackedBytesVector;        // current number of received sacked bytes
+    ConnStatVector *tcpRcvQueueBytesVector;   // current amount of used bytes in tcp receive queue
+    ConnStatVector *tcpRcvQueueDropsVector;   // number of drops in tcp receive queue
 
   protected:
     /** @name FSM transitions: analysing events and executing state transitions */
@@ -584,6 +590,9 @@ class INET_API TCPConnection
     TCPReceiveQueue *getReceiveQueue() {return receiveQueue;}
     TCPAlgorithm *getTcpAlgorithm() {return tcpAlgorithm;}
     TCP *getTcpMain() {return tcpMain;}
+
+    /** Returns true if this connection records output vectors, see ConnStatRecorder */
+    bool isRecordingVectors() const {return recordVectors;}
     //@}
 
     /**
@@ -607,6 +616,24 @@ class INET_API TCPConnection
      */
     virtual bool processAppCommand(cMessage *msg);
 
+    /**
+     * Process data sent by the application via the direct data path
+     * (equivalent of a SEND command). Return value as with processAppCommand().
+     */
+    virtual bool processDirectSend(cPacket *msg);
+
+    /**
+     * Switches the connection to the direct data path; see ITCPDirect.
+     */
+    virtual void setDirectCallback(ITCPDirectCallback *cb, long sendCredit);
+
+    /**
+     * Returns the app's remaining send credit on the direct data path
+     * (LONG_MAX if unlimited). If it is not positive, tcpWritable() will be
+     * called when the send queue has drained.
+     */
+    virtual long getDirectSendCredit();
+
     /**
      * For SACK TCP. RFC 3517, page 3: "This routine returns whether the given
      * sequence number is considered to be lost.  The routine returns true when
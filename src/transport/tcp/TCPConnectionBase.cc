@@ -174,6 +174,10 @@ TCPConnection::TCPConnection()
     sndWndVector = rcvWndVector = rcvAdvVector = sndNxtVector = sndAckVector = rcvSeqVector = rcvAckVector = unackedVector =
     dupAcksVector = sndSacksVector = rcvSacksVector = rcvOooSegVector =
     tcpRcvQueueBytesVector = tcpRcvQueueDropsVector = pipeVector = sackedBytesVector = NULL;
+    recordVectors = false;
+    directCallback = NULL;
+    directSendCredit = 0;
+    directWritableWanted = false;
 }
 
 //
@@ -211,44 +215,29 @@ TCPConnection::TCPConnection(TCP *_mod, int _appGateIndex, int _connId)
     finWait2Timer->setContextPointer(this);
     synRexmitTimer->setContextPointer(this);
 
-    // statistics
-    sndWndVector = NULL;
-    rcvWndVector = NULL;
-    rcvAdvVector = NULL;
-    sndNxtVector = NULL;
-    sndAckVector = NULL;
-    rcvSeqVector = NULL;
-    rcvAckVector = NULL;
-    unackedVector = NULL;
-
-    dupAcksVector = NULL;
-    sndSacksVector = NULL;
-    rcvSacksVector = NULL;
-    rcvOooSegVector = NULL;
-    tcpRcvQueueBytesVector = NULL;
-    tcpRcvQueueDropsVector = NULL;
-    pipeVector = NULL;
-    sackedBytesVector = NULL;
-
-    if (getTcpMain()->recordStatistics)
-    {
-        sndWndVector = new cOutVector("send window");
-        rcvWndVector = new cOutVector("receive window");
-        rcvAdvVector = new cOutVector("advertised window");
-        sndNxtVector = new cOutVector("sent seq");
-        sndAckVector = new cOutVector("sent ack");
-        rcvSeqVector = new cOutVector("rcvd seq");
-        rcvAckVector = new cOutVector("rcvd ack");
-        unackedVector = new cOutVector("unacked bytes");
-        dupAcksVector = new cOutVector("rcvd dupAcks");
-        pipeVector = new cOutVector("pipe");
-        sndSacksVector = new cOutVector("sent sacks");
-        rcvSacksVector = new cOutVector("rcvd sacks");
-        rcvOooSegVector = new cOutVector("rcvd oooseg");
-        sackedBytesVector = new cOutVector("rcvd sackedBytes");
-        tcpRcvQueueBytesVector = new cOutVector("tcpRcvQueueBytes");
-        tcpRcvQueueDropsVector = new cOutVector("tcpRcvQueueDrops");
-    }
+    directCallback = NULL;
+    directSendCredit = 0;
+    directWritableWanted = false;
+
+    // statistics (created only as required by the TCP module's recording policy)
+    ConnStatRecorder& stats = getTcpMain()->connStatRecorder;
+    recordVectors = stats.selectConnection();
+    sndWndVector = stats.createVector("send window", recordVectors);
+    rcvWndVector = stats.createVector("receive window", recordVectors);
+    rcvAdvVector = stats.createVector("advertised window", recordVectors);
+    sndNxtVector = stats.createVector("sent seq", recordVectors);
+    sndAckVector = stats.createVector("sent ack", recordVectors);
+    rcvSeqVector = stats.createVector("rcvd seq", recordVectors);
+    rcvAckVector = stats.createVector("rcvd ack", recordVectors);
+    unackedVector = stats.createVector("unacked bytes", recordVectors);
+    dupAcksVector = stats.createVector("rcvd dupAcks", recordVectors);
+    pipeVector = stats.createVector("pipe", recordVectors);
+    sndSacksVector = stats.createVector("sent sacks", recordVectors);
+    rcvSacksVector = stats.createVector("rcvd sacks", recordVectors);
+    rcvOooSegVector = stats.createVector("rcvd oooseg", recordVectors);
+    sackedBytesVector = stats.createVector("rcvd sackedBytes", recordVectors);
+    tcpRcvQueueBytesVector = stats.createVector("tcpRcvQueueBytes", recordVectors);
+    tcpRcvQueueDropsVector = stats.createVector("tcpRcvQueueDrops", recordVectors);
 }
 
 TCPConnection::~TCPConnection()
@@ -367,6 +356,34 @@ bool TCPConnection::processAppCommand(cMessage *msg)
     return performStateTransition(event);
 }
 
+bool TCPConnection::processDirectSend(cPacket *msg)
+{
+    printConnBrief();
+
+    TCPEventCode event = TCP_E_SEND;
+    tcpEV << "App command (direct): " << eventName(event) << "\n";
+    process_SEND(event, NULL, msg);
+
+    return performStateTransition(event);
+}
+
+void TCPConnection::setDirectCallback(ITCPDirectCallback *cb, long sendCredit)
+{
+    directCallback = cb;
+    directSendCredit = sendCredit;
+    directWritableWanted = false;
+}
+
+long TCPConnection::getDirectSendCredit()
+{
+    if (directSendCredit<=0 || !sendQueue)
+        return LONG_MAX;
+    long credit = directSendCredit - (long)sendQueue->getBytesAvailable(state->snd_una);
+    if (credit<=0)
+        directWritableWanted = true;
+    return credit;
+}
+
 
 TCPEventCode TCPConnection::preanalyseAppCommandEvent(int commandCode)
 {
@@ -542,9 +542,12 @@ TCPEventCode TCPConnection::processSegment1stThru8th(TCPSegment *tcpseg)
                     while ((msg=receiveQueue->extractBytesUpTo(state->rcv_nxt))!=NULL)
                     {
                         msg->setKind(TCP_I_DATA);  // TBD currently we never send TCP_I_URGENT_DATA
-                        TCPCommand *cmd = new TCPCommand();
-                        cmd->setConnId(connId);
-                        msg->setControlInfo(cmd);
+                        if (!directCallback)
+                        {
+                            TCPCommand *cmd = new TCPCommand();
+                            cmd->setConnId(connId);
+                            msg->setControlInfo(cmd);
+                        }
                         sendToApp(msg);
                     }
 
@@ -1211,6 +1214,17 @@ bool TCPConnection::processAckInEstabEtc(TCPSegment *tcpseg)
         if (state->sack_enabled)
             rexmitQueue->discardUpTo(discardUpToSeq);
 
+        // app on the direct data path waiting for send credit?
+        if (directWritableWanted)
+        {
+            long credit = directSendCredit - (long)sendQueue->getBytesAvailable(state->snd_una);
+            if (credit > 0)
+            {
+                directWritableWanted = false;
+                tcpMain->notifyWritableDirect(this, directCallback, credit);
+            }
+        }
+
         updateWndInfo(tcpseg);
 
         // if segment contains data, wait until data has been forwarded to app before sending ACK,
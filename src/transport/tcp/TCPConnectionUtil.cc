@@ -182,6 +182,9 @@ TCPConnection *TCPConnection::cloneListeningConnection()
     conn->tcpAlgorithm = check_and_cast<TCPAlgorithm *>(createOne(tcpAlgorithmClass));
     conn->tcpAlgorithm->setConnection(conn);
 
+    conn->directCallback = directCallback;
+    conn->directSendCredit = directSendCredit;
+
     conn->state = conn->tcpAlgorithm->getStateVariables();
     configureStateVariables();
     conn->tcpAlgorithm->initialize();
@@ -288,7 +291,7 @@ void TCPConnection::sendIndicationToApp(int code)
     TCPCommand *ind = new TCPCommand();
     ind->setConnId(connId);
     msg->setControlInfo(ind);
-    tcpMain->send(msg, "appOut", appGateIndex);
+    sendToApp(msg);
 }
 
 void TCPConnection::sendEstabIndicationToApp()
@@ -305,12 +308,15 @@ void TCPConnection::sendEstabIndicationToApp()
     ind->setRemotePort(remotePort);
 
     msg->setControlInfo(ind);
-    tcpMain->send(msg, "appOut", appGateIndex);
+    sendToApp(msg);
 }
 
 void TCPConnection::sendToApp(cMessage *msg)
 {
-    tcpMain->send(msg, "appOut", appGateIndex);
+    if (directCallback)
+        tcpMain->sendToAppDirect(this, directCallback, msg);
+    else
+        tcpMain->send(msg, "appOut", appGateIndex);
 }
 
 void TCPConnection::initConnection(TCPOpenCommand *openCmd)
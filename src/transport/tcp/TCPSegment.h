@@ -30,6 +30,16 @@ inline bool seqLess(uint32 a, uint32 b) {return a!=b && b-a<(1UL<<31);}
 inline bool seqLE(uint32 a, uint32 b) {return b-a<(1UL<<31);}
 inline bool seqGreater(uint32 a, uint32 b) {return a!=b && a-b<(1UL<<31);}
 inline bool seqGE(uint32 a, uint32 b) {return a-b<(1UL<<31);}
+
+/**
+ * seqLess() as a functor, for ordered containers keyed by sequence number.
+ * It is a valid ordering as long as all keys are within 2^31 of each other,
+ * e.g. within a receive window.
+ */
+struct SeqLess
+{
+    bool operator()(uint32 a, uint32 b) const {return seqLess(a, b);}
+};
 //@}
 
 
@@ -133,16 +133,15 @@ void TCPBaseAlg::initialize()
     delayedAckTimer->setContextPointer(conn);
     keepAliveTimer->setContextPointer(conn);
 
-    if (conn->getTcpMain()->recordStatistics)
-    {
-        cwndVector = new cOutVector("cwnd");
-        ssthreshVector = new cOutVector("ssthresh");
-        rttVector = new cOutVector("measured RTT");
-        srttVector = new cOutVector("smoothed RTT");
-        rttvarVector = new cOutVector("RTTVAR");
-        rtoVector = new cOutVector("RTO");
-        numRtosVector = new cOutVector("numRTOs");
-    }
+    ConnStatRecorder& stats = conn->getTcpMain()->connStatRecorder;
+    bool recordVectors = conn->isRecordingVectors();
+    cwndVector = stats.createVector("cwnd", recordVectors);
+    ssthreshVector = stats.createVector("ssthresh", recordVectors);
+    rttVector = stats.createVector("measured RTT", recordVectors);
+    srttVector = stats.createVector("smoothed RTT", recordVectors);
+    rttvarVector = stats.createVector("RTTVAR", recordVectors);
+    rtoVector = stats.createVector("RTO", recordVectors);
+    numRtosVector = stats.createVector("numRTOs", recordVectors);
 }
 
 void TCPBaseAlg::established(bool active)
@@ -109,13 +109,13 @@ class INET_API TCPBaseAlg : public TCPAlgorithm
     cMessage *delayedAckTimer;
     cMessage *keepAliveTimer;
 
-    cOutVector *cwndVector;  // will record changes to snd_cwnd
-    cOutVector *ssthreshVector; // will record changes to ssthresh
-    cOutVector *rttVector;   // will record measured RTT
-    cOutVector *srttVector;  // will record smoothed RTT
-    cOutVector *rttvarVector;// will record RTT variance (rttvar)
-    cOutVector *rtoVector;   // will record retransmission timeout
-    cOutVector *numRtosVector; // will record total number of RTOs
+    ConnStatVector *cwndVector;  // will record changes to snd_cwnd
+    ConnStatVector *ssthreshVector; // will record changes to ssthresh
+    ConnStatVector *rttVector;   // will record measured RTT
+    ConnStatVector *srttVector;  // will record smoothed RTT
+    ConnStatVector *rttvarVector;// will record RTT variance (rttvar)
+    ConnStatVector *rtoVector;   // will record retransmission timeout
+    ConnStatVector *numRtosVector; // will record total number of RTOs
 
   protected:
     /** @name Process REXMIT, PERSIST, DELAYED-ACK and KEEP-ALIVE timers */
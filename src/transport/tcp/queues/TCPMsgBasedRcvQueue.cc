@@ -42,7 +42,7 @@ std::string TCPMsgBasedRcvQueue::info() const
 
     for (RegionList::const_iterator i = regionList.begin(); i != regionList.end(); ++i)
     {
-        os << " [" << i->begin << ".." << i->end << ")";
+        os << " [" << i->first << ".." << i->second << ")";
     }
 
     os << " " << payloadList.size() << " msgs";
@@ -59,9 +59,8 @@ uint32 TCPMsgBasedRcvQueue::insertBytesFromSegment(TCPSegment *tcpseg)
     while ((msg=tcpseg->removeFirstPayloadMessage(endSeqNo))!=NULL)
     {
         // insert, avoiding duplicates
-        PayloadList::iterator i = payloadList.find(endSeqNo);
-        if (i!=payloadList.end()) {delete msg; continue;}
-        payloadList[endSeqNo] = msg;
+        if (!payloadList.insert(std::make_pair(endSeqNo, msg)).second)
+            delete msg;
     }
 
     return rcv_nxt;
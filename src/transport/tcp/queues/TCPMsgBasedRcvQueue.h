@@ -32,7 +32,7 @@
 class INET_API TCPMsgBasedRcvQueue : public TCPVirtualDataRcvQueue
 {
   protected:
-    typedef std::map<uint32, cPacket *> PayloadList;
+    typedef std::map<uint32, cPacket *, SeqLess> PayloadList;  // keyed by end sequence number
     PayloadList payloadList;
 
   public:
@@ -25,6 +25,7 @@ Register_Class(TCPVirtualDataRcvQueue);
 
 TCPVirtualDataRcvQueue::TCPVirtualDataRcvQueue() : TCPReceiveQueue()
 {
+    bufferedBytes = 0;
 }
 
 TCPVirtualDataRcvQueue::~TCPVirtualDataRcvQueue()
@@ -34,6 +35,8 @@ TCPVirtualDataRcvQueue::~TCPVirtualDataRcvQueue()
 void TCPVirtualDataRcvQueue::init(uint32 startSeq)
 {
     rcv_nxt = startSeq;
+    regionList.clear();
+    bufferedBytes = 0;
 }
 
 std::string TCPVirtualDataRcvQueue::info() const
@@ -45,7 +48,7 @@ std::string TCPVirtualDataRcvQueue::info() const
 
     for (RegionList::const_iterator i=regionList.begin(); i!=regionList.end(); ++i)
     {
-        sprintf(buf, "[%u..%u) ", i->begin, i->end);
+        sprintf(buf, "[%u..%u) ", i->first, i->second);
         res+=buf;
     }
     return res;
@@ -54,8 +57,9 @@ std::string TCPVirtualDataRcvQueue::info() const
 uint32 TCPVirtualDataRcvQueue::insertBytesFromSegment(TCPSegment *tcpseg)
 {
     merge(tcpseg->getSequenceNo(), tcpseg->getSequenceNo()+tcpseg->getPayloadLength());
-    if (seqGE(rcv_nxt, regionList.begin()->begin))
-        rcv_nxt = regionList.begin()->end;
+    RegionList::iterator first = regionList.begin();
+    if (first!=regionList.end() && seqGE(rcv_nxt, first->first))
+        rcv_nxt = first->second;
     return rcv_nxt;
 }
 
@@ -66,64 +70,39 @@ void TCPVirtualDataRcvQueue::merge(uint32 segmentBegin, uint32 segmentEnd)
     // somewhere, or (if it overlaps with an existing region) extend
     // existing regions; we also may have to merge existing regions if
     // they become overlapping (or touching) after adding tcpseg.
+    if (!seqLess(segmentBegin, segmentEnd))
+        return;  // empty regions cannot exist
 
-    Region seg;
-    seg.begin = segmentBegin;
-    seg.end = segmentEnd;
+    uint32 begin = segmentBegin;
+    uint32 end = segmentEnd;
 
-    RegionList::iterator i = regionList.begin();
-    if (i==regionList.end())
-    {
-        // insert as first and only region
-        regionList.insert(regionList.begin(), seg);
-        return;
-    }
-
-    // skip regions which fall entirely before seg (no overlap or touching)
-    while (i!=regionList.end() && seqLess(i->end,seg.begin))
-    {
-        ++i;
-    }
-
-    if (i==regionList.end())
-    {
-        // seg is entirely past last region: insert as separate region at end
-        regionList.insert(regionList.end(), seg);
-        return;
-    }
-
-    if (seqLess(seg.end,i->begin))
+    // the region before seg (if any) is merged if it overlaps or touches seg
+    RegionList::iterator i = regionList.upper_bound(begin);
+    if (i!=regionList.begin())
     {
-        // segment entirely before region "i": insert as separate region before "i"
-        regionList.insert(i, seg);
-        return;
+        RegionList::iterator prev = i;
+        --prev;
+        if (seqGE(prev->second, begin))
+        {
+            if (seqGE(prev->second, end))
+                return;  // seg is already covered entirely
+            begin = prev->first;
+            bufferedBytes -= prev->second - prev->first;
+            regionList.erase(prev);
+        }
     }
 
-    if (seqLess(seg.begin,i->begin))
+    // merge the following regions that overlap or touch seg
+    while (i!=regionList.end() && seqLE(i->first, end))
     {
-        // segment starts before region "i": extend region
-        i->begin = seg.begin;
+        if (seqLess(end, i->second))
+            end = i->second;
+        bufferedBytes -= i->second - i->first;
+        regionList.erase(i++);
     }
 
-    if (seqLess(i->end,seg.end))
-    {
-        // segment ends past end of region "i": extend region
-        i->end = seg.end;
-
-        // maybe we have to merge region "i" with next one(s)
-        RegionList::iterator j = i;
-        ++j;
-        while (j!=regionList.end() && seqGE(i->end,j->begin)) // while there's overlap
-        {
-            // if "j" is longer: extend "i"
-            if (seqLess(i->end,j->end))
-                i->end = j->end;
-
-            // erase "j" (it was merged into "i")
-            RegionList::iterator oldj = j++;
-            regionList.erase(oldj);
-        }
-    }
+    regionList.insert(i, std::make_pair(begin, end));
+    bufferedBytes += end - begin;
 }
 
 cPacket *TCPVirtualDataRcvQueue::extractBytesUpTo(uint32 seq)
@@ -145,42 +124,34 @@ ulong TCPVirtualDataRcvQueue::extractTo(uint32 seq)
     if (i==regionList.end())
         return 0;
 
-    ASSERT(seqLess(i->begin,i->end)); // empty regions cannot exist
+    ASSERT(seqLess(i->first,i->second)); // empty regions cannot exist
 
     // seq below 1st region
-    if (seqLE(seq,i->begin))
+    if (seqLE(seq,i->first))
         return 0;
 
-    if (seqLess(seq,i->end))
+    ulong octets;
+    if (seqLess(seq,i->second))
     {
-        // part of 1st region
-        ulong octets = seq - i->begin;
-        i->begin = seq;
-        return octets;
+        // part of 1st region: the region's key changes, so it is reinserted (still the first one)
+        octets = seq - i->first;
+        uint32 end = i->second;
+        regionList.erase(i);
+        regionList.insert(regionList.begin(), std::make_pair(seq, end));
     }
     else
     {
         // full 1st region
-        ulong octets = i->end - i->begin;
+        octets = i->second - i->first;
         regionList.erase(i);
-        return octets;
     }
+    bufferedBytes -= octets;
+    return octets;
 }
 
 uint32 TCPVirtualDataRcvQueue::getAmountOfBufferedBytes()
 {
-    uint32 bytes=0;
-
-    RegionList::iterator i = regionList.begin();
-    if (i==regionList.end()) // is queue empty?
-        return 0;
-
-    while (i!=regionList.end())
-    {
-        bytes = bytes + (i->end - i->begin);
-        i++;
-    }
-    return bytes;
+    return bufferedBytes;
 }
 
 uint32 TCPVirtualDataRcvQueue::getAmountOfFreeBytes(uint32 maxRcvBuffer)
@@ -200,37 +171,25 @@ void TCPVirtualDataRcvQueue::getQueueStatus()
     tcpEV << "receiveQLength=" << regionList.size() << " " << info() << "\n";
 }
 
+TCPVirtualDataRcvQueue::RegionList::iterator TCPVirtualDataRcvQueue::findRegion(uint32 seq)
+{
+    // the candidate is the last region that begins at or before seq
+    RegionList::iterator i = regionList.upper_bound(seq);
+    if (i==regionList.begin())
+        return regionList.end();
+    --i;
+    return seqLE(seq, i->second) ? i : regionList.end();
+}
 
 uint32 TCPVirtualDataRcvQueue::getLE(uint32 fromSeqNum)
 {
-    RegionList::iterator i = regionList.begin();
-    while (i!=regionList.end())
-    {
-        if (seqLE(i->begin, fromSeqNum) && seqLE(fromSeqNum, i->end))
-        {
-//            tcpEV << "Enqueued region: [" << i->begin << ".." << i->end << ")\n";
-            if (seqLess(i->begin, fromSeqNum))
-                return i->begin;
-            return fromSeqNum;
-        }
-        i++;
-    }
-    return fromSeqNum;
+    RegionList::iterator i = findRegion(fromSeqNum);
+    return i!=regionList.end() ? i->first : fromSeqNum;
 }
 
 uint32 TCPVirtualDataRcvQueue::getRE(uint32 toSeqNum)
 {
-    RegionList::iterator i = regionList.begin();
-    while (i!=regionList.end())
-    {
-        if (seqLE(i->begin, toSeqNum) && seqLE(toSeqNum, i->end))
-        {
-//            tcpEV << "Enqueued region: [" << i->begin << ".." << i->end << ")\n";
-            if (seqLess(toSeqNum, i->end))
-                return i->end;
-            return toSeqNum;
-        }
-        i++;
-    }
-    return toSeqNum;
+    RegionList::iterator i = findRegion(toSeqNum);
+    return i!=regionList.end() ? i->second : toSeqNum;
 }
+
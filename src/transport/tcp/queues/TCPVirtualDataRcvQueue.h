@@ -19,7 +19,7 @@
 #ifndef __INET_TCPVIRTUALDATARCVQUEUE_H
 #define __INET_TCPVIRTUALDATARCVQUEUE_H
 
-#include <list>
+#include <map>
 #include <string>
 #include "TCPSegment.h"
 #include "TCPReceiveQueue.h"
@@ -27,6 +27,12 @@
 /**
  * Receive queue that manages "virtual bytes", that is, byte counts only.
  *
+ * Received byte ranges are kept as disjoint, non-touching regions in a map
+ * ordered by sequence number, so inserting a segment and finding the region
+ * containing a sequence number (SACK blocks, see getLE() and getRE()) costs
+ * O(log n) in the number of holes. The number of buffered bytes is
+ * maintained as a running counter.
+ *
  * @see TCPVirtualDataSendQueue
  */
 class INET_API TCPVirtualDataRcvQueue : public TCPReceiveQueue
@@ -34,13 +40,13 @@ class INET_API TCPVirtualDataRcvQueue : public TCPReceiveQueue
   protected:
     uint32 rcv_nxt;
 
-    struct Region
-    {
-        uint32 begin;
-        uint32 end;
-    };
-    typedef std::list<Region> RegionList;
+    // region begin -> region end (exclusive)
+    typedef std::map<uint32, uint32, SeqLess> RegionList;
     RegionList regionList;
+    uint32 bufferedBytes;  // total length of the regions
+
+    // returns the region containing seq (ends inclusive), or regionList.end()
+    RegionList::iterator findRegion(uint32 seq);
 
     // merges segment byte range into regionList
     void merge(uint32 segmentBegin, uint32 segmentEnd);
@@ -150,6 +150,7 @@ TCP_NSC::TCP_NSC()
   : pStackM(NULL),
     pNsiTimerM(NULL),
     isAliveM(false),
+    wakeupCalledM(false),
     curAddrCounterM(0),
     curConnM(NULL),
 
@@ -419,7 +420,7 @@ void TCP_NSC::changeAddresses(TCP_NSC_Connection &connP,
 void TCP_NSC::handleIpInputMessage(TCPSegment* tcpsegP)
 {
     // get src/dest addresses
-    TCP_NSC_Connection::SockPair nscSockPair, inetSockPair, inetSockPairAny;
+    TCP_NSC_Connection::SockPair nscSockPair, inetSockPair;
 
     if (dynamic_cast<IPControlInfo *>(tcpsegP->getControlInfo())!=NULL)
     {
@@ -466,13 +467,14 @@ void TCP_NSC::handleIpInputMessage(TCPSegment* tcpsegP)
     inetSockPair.localM.portM = tcpsegP->getDestPort();
     nscSockPair.remoteM.portM = tcpsegP->getSrcPort();
     nscSockPair.localM.portM = tcpsegP->getDestPort();
-    inetSockPairAny.localM = inetSockPair.localM;
 
     // process segment
     size_t ipHdrLen = sizeof(nsc_iphdr);
-    size_t const maxBufferSize = 4096;
-    char *data = new char[maxBufferSize];
-    memset(data, 0, maxBufferSize);
+    size_t const maxBufferSize = MAX_SEGMENT_BYTES;
+    char *data = segmentBufferM;
+    // only the IP and TCP headers (max 60 bytes) need clearing,
+    // the payload is overwritten by the serializer
+    memset(data, 0, ipHdrLen + 60);
     uint32_t nscSrcAddr = mapRemote2Nsc(inetSockPair.remoteM.ipAddrM);
     nscSockPair.localM.ipAddrM = localInnerIpS;
     nscSockPair.remoteM.ipAddrM.set(nscSrcAddr);
@@ -501,10 +503,7 @@ void TCP_NSC::handleIpInputMessage(TCPSegment* tcpsegP)
           << "\n";
 
     size_t totalTcpLen = maxBufferSize - ipHdrLen;
-    TCP_NSC_Connection *conn;
-    conn = findConnByInetSockPair(inetSockPair);
-    if (!conn)
-        conn = findConnByInetSockPair(inetSockPairAny);
+    TCP_NSC_Connection *conn = findConnForSegment(inetSockPair, nscSockPair);
     if(conn)
     {
         totalTcpLen = conn->receiveQueueM->insertBytesFromSegment(tcpsegP, (void *)tcph, totalTcpLen);
@@ -528,122 +527,159 @@ void TCP_NSC::handleIpInputMessage(TCPSegment* tcpsegP)
 
     // receive msg from network
 
+    wakeupCalledM = false;
     pStackM->if_receive_packet(0, data, totalIpLen);
 
-    // Attempt to read from sockets
-    TcpAppConnMap::iterator j;
-    int changes = 0;
-    for(j = tcpAppConnMapM.begin(); j != tcpAppConnMapM.end(); ++j)
+    // Service only the socket the segment was delivered to. Other sockets
+    // cannot have become readable or acceptable by this segment, so there is
+    // no need to poll every connection. If the segment cannot be attributed
+    // to a socket but the stack has reported activity via wakeup(), fall
+    // back to checking all sockets.
+    if (conn)
+    {
+        serviceSocket(*conn, inetSockPair, nscSockPair);
+    }
+    else if (wakeupCalledM)
     {
-        TCP_NSC_Connection &c = j->second;
+        tcpEV << this << ": NSC: segment not attributed to any socket, checking all sockets\n";
+        TcpAppConnMap::iterator j;
+        for(j = tcpAppConnMapM.begin(); j != tcpAppConnMapM.end(); ++j)
+            serviceSocket(j->second, inetSockPair, nscSockPair);
+    }
 
-        if(c.pNscSocketM && c.isListenerM)
-        {
-            // accepting socket
-            tcpEV << this << ": NSC: attempting to accept:\n";
+    /*
+    ...
+    NSC: process segment (data,len); should call removeConnection() if socket has
+    closed and completely done
 
-            INetStreamSocket *sock = NULL;
-            int err;
+    XXX: probably need to poll sockets to see if they are closed.
+    ...
+    */
 
-            err = c.pNscSocketM->accept( &sock );
+    delete tcpsegP;
+}
 
-            tcpEV << this << ": accept returned " << err << " , sock is " << sock
-                << " socket" << c.pNscSocketM << "\n";
+TCP_NSC_Connection *TCP_NSC::findConnForSegment(
+        const TCP_NSC_Connection::SockPair &inetSockPairP,
+        const TCP_NSC_Connection::SockPair &nscSockPairP)
+{
+    // established connection: nscSockPair was taken from the segments
+    // the stack has sent, so it matches even after an active open with
+    // unspecified local address or port
+    TCP_NSC_Connection *conn = findConnByNscSockPair(nscSockPairP);
+    if (!conn)
+        conn = findConnByInetSockPair(inetSockPairP);
 
-            if(sock)
-            {
-                ASSERT(changes == 0);
-                ASSERT(c.inetSockPairM.localM.portM == inetSockPair.localM.portM);
-                ++changes;
-
-                TCP_NSC_Connection *conn;
-                int newConnId = ev.getUniqueNumber();
-                // add into appConnMap
-                conn = &tcpAppConnMapM[newConnId];
-                conn->connIdM = newConnId;
-                conn->appGateIndexM = c.appGateIndexM;
-                conn->pNscSocketM = sock;
-
-                // set sockPairs:
-                changeAddresses(*conn, inetSockPair, nscSockPair);
-
-                // following code to be kept consistent with initConnection()
-                const char *sendQueueClass = c.sendQueueM->getClassName();
-                conn->sendQueueM = check_and_cast<TCP_NSC_SendQueue *>(createOne(sendQueueClass));
-                conn->sendQueueM->setConnection(conn);
-
-                const char *receiveQueueClass = c.receiveQueueM->getClassName();
-                conn->receiveQueueM = check_and_cast<TCP_NSC_ReceiveQueue *>(createOne(receiveQueueClass));
-                conn->receiveQueueM->setConnection(conn);
-                tcpEV << this << ": NSC: got accept!\n";
-
-                sendEstablishedMsg(*conn);
-            }
+    // listener bound to the local address, or to any address
+    if (!conn)
+    {
+        TCP_NSC_Connection::SockPair inetSockPairAny;
+        inetSockPairAny.localM = inetSockPairP.localM;
+        conn = findConnByInetSockPair(inetSockPairAny);
+        if (!conn)
+        {
+            inetSockPairAny.localM.ipAddrM = IPvXAddress();
+            conn = findConnByInetSockPair(inetSockPairAny);
         }
-        else if(c.pNscSocketM && c.pNscSocketM->is_connected() ) // not listener
+    }
+    return conn;
+}
+
+void TCP_NSC::serviceSocket(TCP_NSC_Connection &c,
+        const TCP_NSC_Connection::SockPair &inetSockPair,
+        const TCP_NSC_Connection::SockPair &nscSockPair)
+{
+    if(c.pNscSocketM && c.isListenerM)
+    {
+        // accepting socket
+        tcpEV << this << ": NSC: attempting to accept:\n";
+
+        INetStreamSocket *sock = NULL;
+        int err;
+
+        err = c.pNscSocketM->accept( &sock );
+
+        tcpEV << this << ": accept returned " << err << " , sock is " << sock
+            << " socket" << c.pNscSocketM << "\n";
+
+        if(sock)
         {
-            bool hasData = false;
-            tcpEV << this << ": NSC: attempting to read from socket " << c.pNscSocketM << "\n";
+            ASSERT(c.inetSockPairM.localM.portM == inetSockPair.localM.portM);
 
-            if ((!c.sentEstablishedM) && c.pNscSocketM->is_connected())
-            {
-                ASSERT(changes == 0);
-                hasData = true;
-                changeAddresses(c, inetSockPair, nscSockPair);
-                sendEstablishedMsg(c);
-            }
-            while(true)
-            {
-                static char buf[4096];
+            TCP_NSC_Connection *conn;
+            int newConnId = ev.getUniqueNumber();
+            // add into appConnMap
+            conn = &tcpAppConnMapM[newConnId];
+            conn->connIdM = newConnId;
+            conn->appGateIndexM = c.appGateIndexM;
+            conn->pNscSocketM = sock;
 
-                int buflen = sizeof(buf);
+            // set sockPairs:
+            changeAddresses(*conn, inetSockPair, nscSockPair);
 
-                int err = c.pNscSocketM->read_data(buf, &buflen);
+            // following code to be kept consistent with initConnection()
+            const char *sendQueueClass = c.sendQueueM->getClassName();
+            conn->sendQueueM = check_and_cast<TCP_NSC_SendQueue *>(createOne(sendQueueClass));
+            conn->sendQueueM->setConnection(conn);
 
-                tcpEV << this << ": NSC: read: err " << err << " , buflen " << buflen << "\n";
+            const char *receiveQueueClass = c.receiveQueueM->getClassName();
+            conn->receiveQueueM = check_and_cast<TCP_NSC_ReceiveQueue *>(createOne(receiveQueueClass));
+            conn->receiveQueueM->setConnection(conn);
+            tcpEV << this << ": NSC: got accept!\n";
 
-                if(err == 0 && buflen > 0)
-                {
-                    ASSERT(changes == 0);
-                    if(!hasData)
-                        changeAddresses(c, inetSockPair, nscSockPair);
+            sendEstablishedMsg(*conn);
 
-                    hasData = true;
-                    c.receiveQueueM->enqueueNscData(buf, buflen);
-/*
-                    struct sockaddr_in peerAddr,sockAddr;
-                    size_t peerAddrLen=sizeof(peerAddr),sockAddrLen=sizeof(sockAddr);
-                    c.pNscSocketM->getpeername((sockaddr*)&peerAddr, &peerAddrLen);
-                    c.pNscSocketM->getsockname((sockaddr*)&sockAddr, &sockAddrLen);
-*/
-                }
-                else
-                    break;
-            }
-            if(hasData)
-            {
-                while(cPacket *dataMsg = c.receiveQueueM->extractBytesUpTo())
-                {
-                    // send Msg to Application layer:
-                    send(dataMsg, "appOut", c.appGateIndexM);
-                }
-                ++changes;
-                changeAddresses(c, inetSockPair, nscSockPair);
-            }
+            // the segment completing the handshake may already carry data
+            readFromSocket(*conn, inetSockPair, nscSockPair);
         }
     }
+    else if(c.pNscSocketM && c.pNscSocketM->is_connected() ) // not listener
+    {
+        readFromSocket(c, inetSockPair, nscSockPair);
+    }
+}
 
-    /*
-    ...
-    NSC: process segment (data,len); should call removeConnection() if socket has
-    closed and completely done
+void TCP_NSC::readFromSocket(TCP_NSC_Connection &c,
+        const TCP_NSC_Connection::SockPair &inetSockPair,
+        const TCP_NSC_Connection::SockPair &nscSockPair)
+{
+    bool hasData = false;
+    tcpEV << this << ": NSC: attempting to read from socket " << c.pNscSocketM << "\n";
 
-    XXX: probably need to poll sockets to see if they are closed.
-    ...
-    */
+    if ((!c.sentEstablishedM) && c.pNscSocketM->is_connected())
+    {
+        hasData = true;
+        changeAddresses(c, inetSockPair, nscSockPair);
+        sendEstablishedMsg(c);
+    }
+    while(true)
+    {
+        int buflen = sizeof(readBufferM);
 
-    delete [] data;
-    delete tcpsegP;
+        int err = c.pNscSocketM->read_data(readBufferM, &buflen);
+
+        tcpEV << this << ": NSC: read: err " << err << " , buflen " << buflen << "\n";
+
+        if(err == 0 && buflen > 0)
+        {
+            if(!hasData)
+                changeAddresses(c, inetSockPair, nscSockPair);
+
+            hasData = true;
+            c.receiveQueueM->enqueueNscData(readBufferM, buflen);
+        }
+        else
+            break;
+    }
+    if(hasData)
+    {
+        while(cPacket *dataMsg = c.receiveQueueM->extractBytesUpTo())
+        {
+            // send Msg to Application layer:
+            send(dataMsg, "appOut", c.appGateIndexM);
+        }
+        changeAddresses(c, inetSockPair, nscSockPair);
+    }
 }
 
 void TCP_NSC::handleAppMessage(cMessage *msgP)
@@ -845,6 +881,7 @@ void TCP_NSC::wakeup()
     if(!isAliveM)
         return;
     tcpEV << this << ": wakeup() called\n";
+    wakeupCalledM = true;
 }
 
 void TCP_NSC::gettime(unsigned int *secP, unsigned int *usecP)
@@ -1084,15 +1121,25 @@ void TCP_NSC::process_SEND(TCP_NSC_Connection& connP, TCPCommand *tcpCommandP, c
     connP.send(msgP);
 
     connP.do_SEND();
+
+    // let the timer retry what the stack did not accept yet
+    if (connP.sendQueueM->getBytesAvailable() > 0)
+        pendingSendConnIdsM.insert(connP.connIdM);
 }
 
 void TCP_NSC::do_SEND_all()
 {
-    TcpAppConnMap::iterator j = tcpAppConnMapM.begin();
-    for(; j != tcpAppConnMapM.end(); ++j)
+    // only connections with unsent data need to be visited
+    ConnIdSet::iterator j = pendingSendConnIdsM.begin();
+    while (j != pendingSendConnIdsM.end())
     {
-        TCP_NSC_Connection& conn = j->second;
-        conn.do_SEND();
+        TCP_NSC_Connection *conn = findAppConn(*j);
+        if (conn)
+            conn->do_SEND();
+        if (!conn || conn->sendQueueM->getBytesAvailable() == 0)
+            pendingSendConnIdsM.erase(j++);
+        else
+            ++j;
     }
 }
 
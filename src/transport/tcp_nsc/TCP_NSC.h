@@ -23,6 +23,7 @@
 
 #include <map>
 #include <list>
+#include <set>
 #include <omnetpp.h>
 
 #include "INETDefs.h"
@@ -42,6 +43,8 @@ class INET_API TCP_NSC : public cSimpleModule, ISendCallback, IInterruptCallback
 {
   protected:
     enum {MAX_SEND_BYTES = 500000};
+    enum {MAX_SEGMENT_BYTES = 4096};    // max length of an IP packet passed to the stack
+    enum {READ_BUFFER_BYTES = 65536};   // chunk size for reading from NSC sockets
 
   public:
     TCP_NSC();
@@ -86,6 +89,21 @@ class INET_API TCP_NSC : public cSimpleModule, ISendCallback, IInterruptCallback
     void handleAppMessage(cMessage *msgP);
     void handleIpInputMessage(TCPSegment* tcpsegP);
 
+    // find the socket an incoming segment has been delivered to: an existing
+    // connection, or a listener on the destination port; NULL if none
+    TCP_NSC_Connection *findConnForSegment(
+        const TCP_NSC_Connection::SockPair &inetSockPairP,
+        const TCP_NSC_Connection::SockPair &nscSockPairP);
+
+    // accept new connections on a listener, or read data from a connected
+    // socket and pass it up to the application
+    void serviceSocket(TCP_NSC_Connection &connP,
+        const TCP_NSC_Connection::SockPair &inetSockPairP,
+        const TCP_NSC_Connection::SockPair &nscSockPairP);
+    void readFromSocket(TCP_NSC_Connection &connP,
+        const TCP_NSC_Connection::SockPair &inetSockPairP,
+        const TCP_NSC_Connection::SockPair &nscSockPairP);
+
     // function to be called back from the NSC stack:
 
     void sendToIP(const void *dataP, int lenP);
@@ -124,11 +142,13 @@ class INET_API TCP_NSC : public cSimpleModule, ISendCallback, IInterruptCallback
     typedef std::map<u_int32_t, IPvXAddress> Nsc2RemoteMap;
     typedef std::map<IPvXAddress, u_int32_t> Remote2NscMap;
     typedef std::map<TCP_NSC_Connection::SockPair, int> SockPair2ConnIdMap;
+    typedef std::set<int> ConnIdSet;
 
     // Maps:
     TcpAppConnMap tcpAppConnMapM;
     SockPair2ConnIdMap inetSockPair2ConnIdMapM;
     SockPair2ConnIdMap nscSockPair2ConnIdMapM;
+    ConnIdSet pendingSendConnIdsM;  // connections with data not yet accepted by the stack
 
     Nsc2RemoteMap nsc2RemoteMapM;
     Remote2NscMap remote2NscMapM;
@@ -146,6 +166,10 @@ class INET_API TCP_NSC : public cSimpleModule, ISendCallback, IInterruptCallback
 
   protected:
     bool isAliveM;   // true when I between initialize() and finish()
+    bool wakeupCalledM; // set by wakeup(), i.e. the stack has a socket to service
+
+    char segmentBufferM[MAX_SEGMENT_BYTES]; // IP packet passed to if_receive_packet()
+    char readBufferM[READ_BUFFER_BYTES];    // data read from sockets
 
     int curAddrCounterM; // incr, when set curLocalAddr, decr when "felhasznaltam"
     TCP_NSC_Connection *curConnM; // store current connection in connect/listen command
@@ -83,6 +83,9 @@ void UDP::initialize()
     WATCH_PTRMAP(socketsByIdMap);
     WATCH_MAP(socketsByPortMap);
 
+    for (int i=0; i<NUM_KEY_PATTERNS; i++)
+        numSocketsByPattern[i] = 0;
+
     lastEphemeralPort = EPHEMERAL_PORTRANGE_START;
     icmp = NULL;
     icmpv6 = NULL;
@@ -131,6 +134,8 @@ void UDP::bind(int gateIndex, UDPControlInfo *ctrl)
     // add to socketsByPortMap
     SockDescList& list = socketsByPortMap[sd->localPort]; // create if doesn't exist
     list.push_back(sd);
+
+    addToKeyMap(sd);
 }
 
 void UDP::connect(int sockId, IPvXAddress addr, int port)
@@ -144,8 +149,10 @@ void UDP::connect(int sockId, IPvXAddress addr, int port)
         opp_error("connect: invalid remote port number %d", port);
 
     SockDesc *sd = it->second;
+    removeFromKeyMap(sd);
     sd->remoteAddr = addr;
     sd->remotePort = port;
+    addToKeyMap(sd);
 
     sd->onlyLocalPortIsSet = false;
 
@@ -163,6 +170,8 @@ void UDP::unbind(int sockId)
 
     EV << "Unbinding socket: " << *sd << "\n";
 
+    removeFromKeyMap(sd);
+
     // remove from socketsByPortMap
     SockDescList& list = socketsByPortMap[sd->localPort];
     for (SockDescList::iterator it=list.begin(); it!=list.end(); ++it)
@@ -193,6 +202,58 @@ ushort UDP::getEphemeralPort()
     return lastEphemeralPort;
 }
 
+int UDP::getKeyPattern(SockDesc *sd)
+{
+    return (sd->localAddr.isUnspecified() ? 0 : KEY_LOCALADDR) |
+           (sd->remoteAddr.isUnspecified() ? 0 : KEY_REMOTEADDR) |
+           (sd->remotePort==0 ? 0 : KEY_REMOTEPORT);
+}
+
+void UDP::addToKeyMap(SockDesc *sd)
+{
+    SockKey key;
+    key.localAddr = sd->localAddr;
+    key.remoteAddr = sd->remoteAddr;
+    key.localPort = sd->localPort;
+    key.remotePort = sd->remotePort;
+    socketsByKeyMap[key].push_back(sd);
+    numSocketsByPattern[getKeyPattern(sd)]++;
+}
+
+void UDP::removeFromKeyMap(SockDesc *sd)
+{
+    SockKey key;
+    key.localAddr = sd->localAddr;
+    key.remoteAddr = sd->remoteAddr;
+    key.localPort = sd->localPort;
+    key.remotePort = sd->remotePort;
+    SocketsByKeyMap::iterator it = socketsByKeyMap.find(key);
+    ASSERT(it!=socketsByKeyMap.end());
+    it->second.remove(sd);
+    if (it->second.empty())
+        socketsByKeyMap.erase(it);
+    numSocketsByPattern[getKeyPattern(sd)]--;
+}
+
+void UDP::findMatchingSockets(ushort localPort, const IPvXAddress& localAddr, const IPvXAddress& remoteAddr, ushort remotePort)
+{
+    // one exact-match lookup per wildcard combination that has sockets
+    matchingSockets.clear();
+    SockKey key;
+    key.localPort = localPort;
+    for (int pattern=0; pattern<NUM_KEY_PATTERNS; pattern++)
+    {
+        if (numSocketsByPattern[pattern]==0)
+            continue;
+        key.localAddr = (pattern & KEY_LOCALADDR) ? localAddr : IPvXAddress();
+        key.remoteAddr = (pattern & KEY_REMOTEADDR) ? remoteAddr : IPvXAddress();
+        key.remotePort = (pattern & KEY_REMOTEPORT) ? remotePort : 0;
+        SocketsByKeyMap::iterator it = socketsByKeyMap.find(key);
+        if (it!=socketsByKeyMap.end())
+            matchingSockets.insert(matchingSockets.end(), it->second.begin(), it->second.end());
+    }
+}
+
 void UDP::handleMessage(cMessage *msg)
 {
     // received from IP layer
@@ -337,6 +398,13 @@ void UDP::processICMPError(cPacket *msg)
         code = icmpMsg->getCode();
         // Note: we must NOT use decapsulate() because payload in ICMP is conceptually truncated
         IPDatagram *datagram = check_and_cast<IPDatagram *>(icmpMsg->getEncapsulatedMsg());
+        if (!datagram->getEncapsulatedMsg())
+        {
+            // only the last fragment of a datagram carries the UDP packet
+            EV << "ICMP error received about a datagram fragment without UDP header, ignoring\n";
+            delete icmpMsg;
+            return;
+        }
         UDPPacket *packet = check_and_cast<UDPPacket *>(datagram->getEncapsulatedMsg());
         localAddr = datagram->getSrcAddress();
         remoteAddr = datagram->getDestAddress();
@@ -420,47 +488,24 @@ void UDP::processUDPPacket(UDPPacket *udpPacket)
     int destPort = udpPacket->getDestinationPort();
     cPolymorphic *ctrl = udpPacket->removeControlInfo();
 
-    // send back ICMP error if no socket is bound to that port
-    SocketsByPortMap::iterator it = socketsByPortMap.find(destPort);
-    if (it==socketsByPortMap.end())
-    {
-        EV << "No socket registered on port " << destPort << "\n";
-        processUndeliverablePacket(udpPacket, ctrl);
-        return;
-    }
-    SockDescList& list = it->second;
-
+    // find candidate sockets by address/port binding, then let matchesSocket()
+    // check the rest (e.g. interfaceId)
     int matches = 0;
-
-    // deliver a copy of the packet to each matching socket
-    cPacket *payload = udpPacket->getEncapsulatedMsg();
     if (dynamic_cast<IPControlInfo *>(ctrl)!=NULL)
     {
         IPControlInfo *ctrl4 = (IPControlInfo *)ctrl;
-        for (SockDescList::iterator it=list.begin(); it!=list.end(); ++it)
-        {
-            SockDesc *sd = *it;
-            if (sd->onlyLocalPortIsSet || matchesSocket(sd, udpPacket, ctrl4))
-            {
-                EV << "Socket sockId=" << sd->sockId << " matches, sending up a copy.\n";
-                sendUp((cPacket*)payload->dup(), udpPacket, ctrl4, sd);
-                matches++;
-            }
-        }
+        findMatchingSockets(destPort, ctrl4->getDestAddr(), ctrl4->getSrcAddr(), udpPacket->getSourcePort());
+        for (int i=0; i<(int)matchingSockets.size(); i++)
+            if (matchingSockets[i]->onlyLocalPortIsSet || matchesSocket(matchingSockets[i], udpPacket, ctrl4))
+                matchingSockets[matches++] = matchingSockets[i];
     }
     else if (dynamic_cast<IPv6ControlInfo *>(ctrl)!=NULL)
     {
         IPv6ControlInfo *ctrl6 = (IPv6ControlInfo *)ctrl;
-        for (SockDescList::iterator it=list.begin(); it!=list.end(); ++it)
-        {
-            SockDesc *sd = *it;
-            if (sd->onlyLocalPortIsSet || matchesSocket(sd, udpPacket, ctrl6))
-            {
-                EV << "Socket sockId=" << sd->sockId << " matches, sending up a copy.\n";
-                sendUp((cPacket*)payload->dup(), udpPacket, ctrl6, sd);
-                matches++;
-            }
-        }
+        findMatchingSockets(destPort, ctrl6->getDestAddr(), ctrl6->getSrcAddr(), udpPacket->getSourcePort());
+        for (int i=0; i<(int)matchingSockets.size(); i++)
+            if (matchingSockets[i]->onlyLocalPortIsSet || matchesSocket(matchingSockets[i], udpPacket, ctrl6))
+                matchingSockets[matches++] = matchingSockets[i];
     }
     else
     {
@@ -470,11 +515,26 @@ void UDP::processUDPPacket(UDPPacket *udpPacket)
     // send back ICMP error if there is no matching socket
     if (matches==0)
     {
-        EV << "None of the sockets on port " << destPort << " matches the packet\n";
+        EV << "No socket on port " << destPort << " matches the packet\n";
         processUndeliverablePacket(udpPacket, ctrl);
         return;
     }
 
+    // deliver a copy of the packet to each matching socket except the
+    // last one, which gets the original
+    cPacket *payload = udpPacket->getEncapsulatedMsg();
+    for (int i=0; i<matches; i++)
+    {
+        SockDesc *sd = matchingSockets[i];
+        bool isLast = (i==matches-1);
+        EV << "Socket sockId=" << sd->sockId << " matches, sending up " << (isLast ? "the packet" : "a copy") << ".\n";
+        cPacket *packet = isLast ? udpPacket->decapsulate() : (cPacket *)payload->dup();
+        if (dynamic_cast<IPControlInfo *>(ctrl)!=NULL)
+            sendUp(packet, udpPacket, (IPControlInfo *)ctrl, sd);
+        else
+            sendUp(packet, udpPacket, (IPv6ControlInfo *)ctrl, sd);
+    }
+
     delete udpPacket;
     delete ctrl;
 }
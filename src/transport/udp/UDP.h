@@ -27,6 +27,8 @@
 
 #include <map>
 #include <list>
+#include <vector>
+#include "HashMap.h"
 #include "UDPControlInfo_m.h"
 
 class IPControlInfo;
@@ -63,10 +65,53 @@ class INET_API UDP : public cSimpleModule
     typedef std::map<int,SockDesc *> SocketsByIdMap;
     typedef std::map<int,SockDescList> SocketsByPortMap;
 
+    //
+    // Exact-match demultiplexing key. Sockets are indexed with their
+    // unspecified fields left as wildcards (unspecified address, port 0);
+    // incoming packets are looked up once per wildcard combination in use.
+    //
+    struct SockKey
+    {
+        IPvXAddress localAddr;
+        IPvXAddress remoteAddr;
+        ushort localPort;
+        ushort remotePort;
+
+        bool operator==(const SockKey& other) const {
+            return localPort==other.localPort && remotePort==other.remotePort &&
+                   localAddr==other.localAddr && remoteAddr==other.remoteAddr;
+        }
+    };
+
+    struct SockKeyHash
+    {
+        size_t operator()(const SockKey& k) const {
+            unsigned int h = (k.localPort << 16) | k.remotePort;
+            for (int i=0; i<k.localAddr.wordCount(); i++)
+                h = h*31 + k.localAddr.words()[i];
+            for (int i=0; i<k.remoteAddr.wordCount(); i++)
+                h = h*31 + k.remoteAddr.words()[i];
+            return inet_hashInt(h);
+        }
+    };
+
+    typedef inet_hash::unordered_map<SockKey,SockDescList,SockKeyHash> SocketsByKeyMap;
+
+    // wildcard combinations: which of localAddr, remoteAddr, remotePort are bound
+    enum {
+        KEY_LOCALADDR = 1,
+        KEY_REMOTEADDR = 2,
+        KEY_REMOTEPORT = 4,
+        NUM_KEY_PATTERNS = 8
+    };
+
   protected:
     // sockets
     SocketsByIdMap socketsByIdMap;
     SocketsByPortMap socketsByPortMap;
+    SocketsByKeyMap socketsByKeyMap;
+    int numSocketsByPattern[NUM_KEY_PATTERNS];
+    std::vector<SockDesc *> matchingSockets; // reused by processUDPPacket()
 
     // other state vars
     ushort lastEphemeralPort;
@@ -95,6 +140,14 @@ class INET_API UDP : public cSimpleModule
     // ephemeral port
     virtual ushort getEphemeralPort();
 
+    // maintain socketsByKeyMap
+    virtual void addToKeyMap(SockDesc *sd);
+    virtual void removeFromKeyMap(SockDesc *sd);
+    static int getKeyPattern(SockDesc *sd);
+
+    // collect sockets whose address/port binding matches the packet into matchingSockets
+    virtual void findMatchingSockets(ushort localPort, const IPvXAddress& localAddr, const IPvXAddress& remoteAddr, ushort remotePort);
+
     virtual bool matchesSocket(SockDesc *sd, UDPPacket *udp, IPControlInfo *ctrl);
     virtual bool matchesSocket(SockDesc *sd, UDPPacket *udp, IPv6ControlInfo *ctrl);
     virtual bool matchesSocket(SockDesc *sd, const IPvXAddress& localAddr, const IPvXAddress& remoteAddr, ushort remotePort);
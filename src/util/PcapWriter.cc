@@ -0,0 +1,270 @@
+//
+// Copyright (C) 2009 Andras Varga
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include <errno.h>
+#include "PcapWriter.h"
+#include "IPSerializer.h"
+
+
+#define PCAP_MAGIC           0xa1b2c3d4
+#define PCAPNG_BYTE_ORDER    0x1a2b3c4d
+#define PCAPNG_SHB           0x0a0d0d0a  // section header block
+#define PCAPNG_IDB           0x00000001  // interface description block
+#define PCAPNG_EPB           0x00000006  // enhanced packet block
+#define DLT_NULL_HDR_BYTES   4           // address family, host byte order
+#define AF_INET_VALUE        2
+#define MAX_IP_PACKET_BYTES  65536
+
+/* "libpcap" file header */
+struct pcap_hdr {
+     uint32 magic;          /* magic */
+     uint16 version_major;  /* major version number */
+     uint16 version_minor;  /* minor version number */
+     uint32 thiszone;       /* GMT to local correction */
+     uint32 sigfigs;        /* accuracy of timestamps */
+     uint32 snaplen;        /* max length of captured packets, in octets */
+     uint32 network;        /* data link type */
+};
+
+/* "libpcap" record header */
+struct pcaprec_hdr {
+     int32  ts_sec;         /* timestamp seconds */
+     uint32 ts_usec;        /* timestamp microseconds */
+     uint32 incl_len;       /* number of octets of packet saved in file */
+     uint32 orig_len;       /* actual length of packet */
+};
+
+/* pcap-ng section header block */
+struct pcapng_shb {
+     uint32 block_type;
+     uint32 block_total_length;
+     uint32 byte_order_magic;
+     uint16 version_major;
+     uint16 version_minor;
+     uint32 section_length_low;
+     uint32 section_length_high;
+     uint32 block_total_length2;
+};
+
+/* pcap-ng interface description block, with the if_tsresol option */
+struct pcapng_idb {
+     uint32 block_type;
+     uint32 block_total_length;
+     uint16 linktype;
+     uint16 reserved;
+     uint32 snaplen;
+     uint16 tsresol_code;
+     uint16 tsresol_length;
+     uint8  tsresol;
+     uint8  tsresol_padding[3];
+     uint32 end_of_options;
+     uint32 block_total_length2;
+};
+
+/* pcap-ng enhanced packet block, up to the packet data */
+struct pcapng_epb_hdr {
+     uint32 block_type;
+     uint32 block_total_length;
+     uint32 interface_id;
+     uint32 ts_high;        /* timestamp, in units of if_tsresol */
+     uint32 ts_low;
+     uint32 captured_len;
+     uint32 packet_len;
+};
+
+// largest record writeIPPacket() may produce (pcap-ng: block header, padding, trailing length)
+#define MAX_RECORD_BYTES  (sizeof(pcapng_epb_hdr) + DLT_NULL_HDR_BYTES + MAX_IP_PACKET_BYTES + 3 + sizeof(uint32))
+
+
+static uint64 toNanoseconds(simtime_t t)
+{
+#ifdef USE_DOUBLE_SIMTIME
+    return (uint64)(t * 1000000000.0 + 0.5);
+#else
+    int64 raw = t.raw();
+    int64 scale = t.getScale();  // always 10^n
+    if (scale > 1000000000)
+        return raw / (scale / 1000000000);
+    else
+        return raw * (1000000000 / scale);
+#endif
+}
+
+
+PcapWriter::PcapWriter()
+{
+    f = NULL;
+    format = PCAP;
+    snaplen = 0;
+    buffer = NULL;
+    bufferSize = bufferUsed = 0;
+    numPackets = 0;
+}
+
+PcapWriter::~PcapWriter()
+{
+    close();
+}
+
+void PcapWriter::open(const char *filename, const char *formatName, uint32 snaplen, size_t bufferSize)
+{
+    if (!strcmp(formatName, "pcap"))
+        format = PCAP;
+    else if (!strcmp(formatName, "pcapng"))
+        format = PCAPNG;
+    else
+        opp_error("PcapWriter: invalid format '%s', must be pcap or pcapng", formatName);
+
+    if (f)
+        close();
+    f = fopen(filename, "wb");
+    if (!f)
+        opp_error("PcapWriter: cannot open file `%s' for writing: %s", filename, strerror(errno));
+
+    this->snaplen = snaplen;
+    this->bufferSize = std::max(bufferSize, (size_t)MAX_RECORD_BYTES);
+    buffer = new unsigned char[this->bufferSize];
+    bufferUsed = 0;
+    numPackets = 0;
+
+    writeFileHeader();
+}
+
+void PcapWriter::writeFileHeader()
+{
+    if (format==PCAP)
+    {
+        struct pcap_hdr fh;
+        fh.magic = PCAP_MAGIC;
+        fh.version_major = 2;
+        fh.version_minor = 4;
+        fh.thiszone = 0;
+        fh.sigfigs = 0;
+        fh.snaplen = snaplen;
+        fh.network = 0;  // DLT_NULL
+        writeBytes(&fh, sizeof(fh));
+    }
+    else
+    {
+        struct pcapng_shb shb;
+        shb.block_type = PCAPNG_SHB;
+        shb.block_total_length = shb.block_total_length2 = sizeof(shb);
+        shb.byte_order_magic = PCAPNG_BYTE_ORDER;
+        shb.version_major = 1;
+        shb.version_minor = 0;
+        shb.section_length_low = shb.section_length_high = 0xffffffff;  // unspecified
+        writeBytes(&shb, sizeof(shb));
+
+        struct pcapng_idb idb;
+        idb.block_type = PCAPNG_IDB;
+        idb.block_total_length = idb.block_total_length2 = sizeof(idb);
+        idb.linktype = 0;  // DLT_NULL
+        idb.reserved = 0;
+        idb.snaplen = snaplen;
+        idb.tsresol_code = 9;
+        idb.tsresol_length = 1;
+        idb.tsresol = 9;  // 10^-9 s, i.e. nanosecond timestamps
+        memset(idb.tsresol_padding, 0, sizeof(idb.tsresol_padding));
+        idb.end_of_options = 0;
+        writeBytes(&idb, sizeof(idb));
+    }
+}
+
+void PcapWriter::ensureSpace(size_t bytes)
+{
+    if (bufferUsed + bytes > bufferSize)
+        flush();
+}
+
+void PcapWriter::writeBytes(const void *data, size_t length)
+{
+    ensureSpace(length);
+    memcpy(buffer + bufferUsed, data, length);
+    bufferUsed += length;
+}
+
+void PcapWriter::writeIPPacket(simtime_t stime, const IPDatagram *dgram)
+{
+    if (!f)
+        opp_error("PcapWriter: file not open");
+
+    // serialize directly into the write buffer, after room for the record header
+    ensureSpace(MAX_RECORD_BYTES);
+    unsigned char *record = buffer + bufferUsed;
+    size_t headerLength = format==PCAP ? sizeof(pcaprec_hdr) : sizeof(pcapng_epb_hdr);
+    unsigned char *data = record + headerLength;
+
+    uint32 af = AF_INET_VALUE;
+    memcpy(data, &af, DLT_NULL_HDR_BYTES);
+    int ipLength = IPSerializer().serialize(dgram, data + DLT_NULL_HDR_BYTES, MAX_IP_PACKET_BYTES);
+
+    uint32 origLength = ipLength + DLT_NULL_HDR_BYTES;
+    uint32 inclLength = std::min(origLength, snaplen);
+    uint64 ns = toNanoseconds(stime);
+
+    if (format==PCAP)
+    {
+        struct pcaprec_hdr ph;
+        ph.ts_sec = (int32)(ns / 1000000000);
+        ph.ts_usec = (uint32)((ns % 1000000000) / 1000);
+        ph.incl_len = inclLength;
+        ph.orig_len = origLength;
+        memcpy(record, &ph, sizeof(ph));
+        bufferUsed += headerLength + inclLength;  // truncated bytes get overwritten by the next record
+    }
+    else
+    {
+        uint32 paddedLength = (inclLength + 3) & ~3;
+        uint32 blockLength = headerLength + paddedLength + sizeof(uint32);
+        struct pcapng_epb_hdr eh;
+        eh.block_type = PCAPNG_EPB;
+        eh.block_total_length = blockLength;
+        eh.interface_id = 0;
+        eh.ts_high = (uint32)(ns >> 32);
+        eh.ts_low = (uint32)(ns & 0xffffffff);
+        eh.captured_len = inclLength;
+        eh.packet_len = origLength;
+        memcpy(record, &eh, sizeof(eh));
+        memset(data + inclLength, 0, paddedLength - inclLength);
+        memcpy(data + paddedLength, &blockLength, sizeof(uint32));
+        bufferUsed += blockLength;
+    }
+    numPackets++;
+}
+
+void PcapWriter::flush()
+{
+    if (!f || bufferUsed==0)
+        return;
+    if (fwrite(buffer, bufferUsed, 1, f) != 1)
+        opp_error("PcapWriter: cannot write file: %s", strerror(errno));
+    bufferUsed = 0;
+    fflush(f);
+}
+
+void PcapWriter::close()
+{
+    if (!f)
+        return;
+    flush();
+    fclose(f);
+    f = NULL;
+    delete [] buffer;
+    buffer = NULL;
+}
+
@@ -0,0 +1,86 @@
+//
+// Copyright (C) 2009 Andras Varga
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_PCAPWRITER_H
+#define __INET_PCAPWRITER_H
+
+#include <stdio.h>
+#include <omnetpp.h>
+#include "INETDefs.h"
+#include "IPDatagram.h"
+
+
+/**
+ * Writes IP datagrams into a libpcap or pcap-ng file.
+ *
+ * Records are assembled in a large write buffer, and datagrams are
+ * serialized directly into that buffer; the file is only written when
+ * the buffer fills up, on flush() and on close(). Packets longer than
+ * snaplen are truncated. pcap-ng files carry nanosecond timestamps,
+ * libpcap files microsecond ones.
+ *
+ * The link type is DLT_NULL (a 4-byte address family header in host
+ * byte order followed by the IP datagram), as no link-layer headers
+ * are serialized.
+ */
+class INET_API PcapWriter
+{
+  public:
+    enum Format {PCAP, PCAPNG};
+
+  protected:
+    FILE *f;
+    Format format;
+    uint32 snaplen;
+    unsigned char *buffer;  // write buffer
+    size_t bufferSize;
+    size_t bufferUsed;
+    unsigned long numPackets;
+
+  protected:
+    virtual void writeFileHeader();
+    virtual void ensureSpace(size_t bytes);
+    virtual void writeBytes(const void *data, size_t length);
+
+  public:
+    PcapWriter();
+    virtual ~PcapWriter();
+
+    /**
+     * Opens the file and writes the file header. format is "pcap" or
+     * "pcapng"; bufferSize is the size of the write buffer in bytes.
+     */
+    virtual void open(const char *filename, const char *format, uint32 snaplen, size_t bufferSize);
+
+    /** Returns true between open() and close() */
+    bool isOpen() const {return f!=NULL;}
+
+    /** Appends the datagram to the file, with the given timestamp */
+    virtual void writeIPPacket(simtime_t stime, const IPDatagram *dgram);
+
+    /** Writes out the buffered records */
+    virtual void flush();
+
+    /** Flushes and closes the file; no-op if it is not open */
+    virtual void close();
+
+    /** Number of packets written since open() */
+    unsigned long getNumPackets() const {return numPackets;}
+};
+
+#endif
+
@@ -23,7 +23,6 @@
 #include "IPControlInfo_m.h"
 #include "SCTPMessage.h"
 #include "SCTPAssociation.h"
-#include "IPSerializer.h"
 #include "ICMPMessage.h"
 #include "UDPPacket_m.h"
 
@@ -31,8 +30,6 @@
 #include <netinet/in.h>  // htonl, ntohl, ...
 #endif
 
-#define MAXBUFLENGTH 65536
-
 TCPDumper::TCPDumper(std::ostream& out)
 {
      outp = &out;
@@ -519,38 +516,18 @@ void TCPDumper::tcpDump(bool l2r, const char *label, TCPSegment *tcpseg, const s
 
 void TCPDump::initialize()
 {
-    struct pcap_hdr fh;
     const char* file = this->par("dumpFile");
     snaplen = this->par("snaplen");
     tcpdump.setVerbosity(par("verbosity"));
 
-
     if (strcmp(file,"")!=0)
-    {
-        tcpdump.dumpfile = fopen(file, "wb");
-        if (!tcpdump.dumpfile)
-        {
-            fprintf(stderr, "Cannot open file [%s] for writing: %s\n", file, strerror(errno));
-            exit(-1);
-        }
-
-        fh.magic = PCAP_MAGIC;
-        fh.version_major = 2;
-        fh.version_minor = 4;
-        fh.thiszone = 0;
-        fh.sigfigs = 0;
-        fh.snaplen = snaplen;
-        fh.network = 0;
-        fwrite(&fh, sizeof(fh), 1, tcpdump.dumpfile);
-    }
-    else
-        tcpdump.dumpfile = NULL;
+        pcapWriter.open(file, par("dumpFormat"), snaplen, (long)par("dumpBufferSize"));
 }
 
 void TCPDump::handleMessage(cMessage *msg)
 {
-
-    if (!ev.disable_tracing)
+    // only packets are dumped; other messages (e.g. commands) are just passed through
+    if (!ev.disable_tracing && msg->isPacket())
     {
         bool l2r;
 
@@ -626,31 +603,14 @@ void TCPDump::handleMessage(cMessage *msg)
     }
 
 
-    if (tcpdump.dumpfile!=NULL && dynamic_cast<IPDatagram *>(msg))
+    if (pcapWriter.isOpen() && msg->isPacket())
     {
-        uint8 buf[MAXBUFLENGTH];
-        memset((void*)&buf, 0, sizeof(buf));
-
-        const simtime_t stime = simulation.getSimTime();
-        // Write PCap header
-
-        struct pcaprec_hdr ph;
-        ph.ts_sec = (int32)stime.dbl();
-        ph.ts_usec = (uint32)((stime.dbl() - ph.ts_sec)*1000000);
-         // Write Ethernet header
-        uint32 hdr = 2; //AF_INET
-                     //We do not want this to end in an error if EtherAutoconf messages
-        IPDatagram *ipPacket = check_and_cast<IPDatagram *>(msg);
-        // IP header:
-        //struct sockaddr_in *to = (struct sockaddr_in*) malloc(sizeof(struct sockaddr_in));
-        //int32 tosize = sizeof(struct sockaddr_in);
-        int32 serialized_ip = IPSerializer().serialize(ipPacket, buf, sizeof(buf));
-        ph.incl_len = serialized_ip + sizeof(uint32);
-
-        ph.orig_len = ph.incl_len;
-        fwrite(&ph, sizeof(ph), 1, tcpdump.dumpfile);
-        fwrite(&hdr, sizeof(uint32), 1, tcpdump.dumpfile);
-        fwrite(buf, serialized_ip, 1, tcpdump.dumpfile);
+        // capture at any layer: look for an IP datagram inside the message
+        cPacket *encapmsg = PK(msg);
+        while (encapmsg && dynamic_cast<IPDatagram *>(encapmsg)==NULL)
+            encapmsg = encapmsg->getEncapsulatedMsg();
+        if (encapmsg)
+            pcapWriter.writeIPPacket(simulation.getSimTime(), (IPDatagram *)encapmsg);
     }
 
 
@@ -668,7 +628,6 @@ void TCPDump::handleMessage(cMessage *msg)
 void TCPDump::finish()
 {
      tcpdump.dump("", "tcpdump finished");
-     if (strcmp(this->par("dumpFile"),"")!=0)
-          fclose(tcpdump.dumpfile);
+     pcapWriter.close();
 }
 
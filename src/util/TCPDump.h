@@ -28,29 +28,10 @@
 #include "SCTPMessage.h"
 #include "TCPSegment.h"
 #include "IPv6Datagram_m.h"
+#include "PcapWriter.h"
 
-#define PCAP_MAGIC           0xa1b2c3d4
 #define RBUFFER_SIZE 65535
 
-/* "libpcap" file header (minus magic number). */
-struct pcap_hdr {
-     uint32 magic;      /* magic */
-     uint16 version_major;   /* major version number */
-     uint16 version_minor;   /* minor version number */
-     uint32 thiszone;   /* GMT to local correction */
-     uint32 sigfigs;        /* accuracy of timestamps */
-     uint32 snaplen;        /* max length of captured packets, in octets */
-     uint32 network;        /* data link type */
-};
-
-/* "libpcap" record header. */
-struct pcaprec_hdr {
-     int32  ts_sec;     /* timestamp seconds */
-     uint32 ts_usec;        /* timestamp microseconds */
-     uint32 incl_len;   /* number of octets of packet saved in file */
-     uint32 orig_len;   /* actual length of packet */
-};
-
 typedef struct {
      uint8  dest_addr[6];
      uint8  src_addr[6];
@@ -87,7 +68,6 @@ class TCPDumper
         void dumpIPv6(bool l2r, const char *label, IPv6Datagram_Base *dgram, const char *comment=NULL);//FIXME: Temporary hack
         void udpDump(bool l2r, const char *label, IPDatagram *dgram, const char *comment);
         const char* intToChunk(int32 type);
-        FILE *dumpfile;
     private:
         int verbosity;
 };
@@ -101,6 +81,7 @@ class INET_API TCPDump : public cSimpleModule
     protected:
         unsigned char* ringBuffer[RBUFFER_SIZE];
         TCPDumper tcpdump;
+        PcapWriter pcapWriter;
         unsigned int snaplen;
         unsigned long first, last, space;
 
@@ -76,6 +76,16 @@ int IPSerializer::serialize(const IPDatagram *dgram, unsigned char *buf, unsigne
     packetLength = IP_HEADER_BYTES;
 
     cMessage *encapPacket = dgram->getEncapsulatedMsg();
+
+    // fragments: only the last one carries the modelled packet, and even
+    // that is not a complete transport-layer packet, so serialize the IP
+    // header only
+    if (!encapPacket || dgram->getFragmentOffset()!=0 || dgram->getMoreFragments())
+    {
+        ip->ip_len = htons(packetLength);
+        return packetLength;
+    }
+
     switch (dgram->getTransportProtocol())
     {
       case IP_PROT_ICMP:
@@ -16,8 +16,13 @@
 
 
 #include "ChannelControl.h"
+#include "BasicMobility.h"
 #include "FWMath.h"
 #include <cassert>
+#include <algorithm>
+
+// upper limit for the number of grid columns/rows used in the bulk connection update
+#define MAX_GRID_DIMENSION 1000
 
 
 #define coreEV (ev.isDisabled()||!coreDebug) ? ev : ev << "ChannelControl: "
@@ -41,10 +46,15 @@ std::ostream& operator<<(std::ostream& os, const ChannelControl::TransmissionLis
 
 ChannelControl::ChannelControl()
 {
+    mobilityTimer = NULL;
+    gridCellSize = 0;
+    gridCols = gridRows = 0;
+    gridMaxSpeed = 0;
 }
 
 ChannelControl::~ChannelControl()
 {
+    cancelAndDelete(mobilityTimer);
     for (unsigned int i = 0; i < transmissions.size(); i++)
         for (TransmissionList::iterator it = transmissions[i].begin(); it != transmissions[i].end(); it++)
             delete *it;
@@ -56,7 +66,16 @@ ChannelControl *ChannelControl::get()
     if (!cc)
         cc = dynamic_cast<ChannelControl *>(simulation.getModuleByPath("channelControl"));
     if (!cc)
+    {
+        // with parallel simulation, it may be a placeholder for a module in another partition
+        cModule *mod = simulation.getModuleByPath("channelcontrol");
+        if (!mod)
+            mod = simulation.getModuleByPath("channelControl");
+        if (mod && mod->isPlaceholder())
+            throw cRuntimeError("ChannelControl module is in another partition: a wireless network "
+                                "cannot be split across partitions of a parallel simulation");
         throw cRuntimeError("Could not find ChannelControl module");
+    }
     return cc;
 }
 
@@ -76,6 +95,7 @@ void ChannelControl::initialize()
     playgroundSize.y = par("playgroundSizeY");
 
     numChannels = par("numChannels");
+    trajectoryBased = par("trajectoryBasedPositions");
     transmissions.resize(numChannels);
 
     lastOngoingTransmissionsUpdate = 0;
@@ -151,7 +171,14 @@ ChannelControl::HostRef ChannelControl::registerHost(cModule *host, const Coord&
     he.pos = initialPos;
     he.isNeighborListValid = false;
     he.channel = 0;  // for now
+    he.mobility = NULL;
+    he.neighborsChanged = false;
+    he.trajectory = NULL;
+    he.speed = 0;
+    he.gridCell = -1;
     hosts.push_back(he);
+    if (trajectoryBased)
+        updateGridCell(&hosts.back());
     return &hosts.back(); // last element
 }
 
@@ -164,9 +191,48 @@ ChannelControl::HostRef ChannelControl::lookupHost(cModule *host)
     return 0;
 }
 
+ChannelControl::HostRef ChannelControl::lookupHostContaining(cModule *mod)
+{
+    Enter_Method_Silent();
+    for (HostList::iterator it = hosts.begin(); it != hosts.end(); it++)
+        for (cModule *m = mod; m; m = m->getParentModule())
+            if (it->host == m)
+                return &(*it);
+    return 0;
+}
+
 const ChannelControl::HostRefVector& ChannelControl::getNeighbors(HostRef h)
 {
     Enter_Method_Silent();
+    if (trajectoryBased)
+    {
+        // neighbors are not cached, as positions change continuously. Hosts are
+        // in the grid cell of a position they had at or after gridTime, so they
+        // moved at most slack since; only the cells within interference distance
+        // plus twice that need to be checked. The grid is rebuilt when this
+        // would mean more than the 5x5 cells around the host.
+        if (grid.empty() || gridMaxSpeed * SIMTIME_DBL(simTime() - gridTime) > maxInterferenceDistance / 2)
+            buildTrajectoryGrid();
+        double slack = gridMaxSpeed * SIMTIME_DBL(simTime() - gridTime);
+        int d = (int)ceil((maxInterferenceDistance + 2 * slack) / gridCellSize);
+        int col = h->gridCell % gridCols;
+        int row = h->gridCell / gridCols;
+
+        Coord hpos = getHostPosition(h);
+        double maxDistSquared = maxInterferenceDistance * maxInterferenceDistance;
+        h->neighborList.clear();
+        for (int r = std::max(0, row-d); r <= std::min(gridRows-1, row+d); r++)
+        {
+            for (int c = std::max(0, col-d); c <= std::min(gridCols-1, col+d); c++)
+            {
+                HostRefVector& cell = grid[r * gridCols + c];
+                for (unsigned int j = 0; j < cell.size(); j++)
+                    if (cell[j] != h && hpos.sqrdist(getHostPosition(cell[j])) < maxDistSquared)
+                        h->neighborList.push_back(cell[j]);
+            }
+        }
+        return h->neighborList;
+    }
     if (!h->isNeighborListValid)
     {
         h->neighborList.clear();
@@ -212,6 +278,69 @@ void ChannelControl::updateConnections(HostRef h)
     }
 }
 
+void ChannelControl::updateConnections(const HostRefVector& movedHosts)
+{
+    // sort hosts into a grid of cells at least maxInterferenceDistance wide,
+    // so that the neighbors of a host can only be in the 3x3 cells around it
+    double cellSize = std::max(maxInterferenceDistance,
+                               std::max(playgroundSize.x, playgroundSize.y) / MAX_GRID_DIMENSION);
+    int numCols = (int)(playgroundSize.x / cellSize) + 1;
+    int numRows = (int)(playgroundSize.y / cellSize) + 1;
+    grid.resize(numCols * numRows);
+    for (unsigned int i = 0; i < grid.size(); i++)
+        grid[i].clear();  // keeps the capacity for the next update
+
+    for (HostList::iterator it = hosts.begin(); it != hosts.end(); ++it)
+    {
+        int col = std::max(0, std::min(numCols-1, (int)(it->pos.x / cellSize)));
+        int row = std::max(0, std::min(numRows-1, (int)(it->pos.y / cellSize)));
+        grid[row * numCols + col].push_back(&(*it));
+    }
+
+    double maxDistSquared = maxInterferenceDistance * maxInterferenceDistance;
+    for (unsigned int i = 0; i < movedHosts.size(); i++)
+    {
+        HostRef h = movedHosts[i];
+        Coord& hpos = h->pos;
+
+        // disconnect neighbors that got out of range
+        for (std::set<HostRef>::iterator it = h->neighbors.begin(); it != h->neighbors.end();)
+        {
+            HostRef hi = *it;
+            if (hpos.sqrdist(hi->pos) < maxDistSquared)
+                ++it;
+            else
+            {
+                h->neighbors.erase(it++);
+                hi->neighbors.erase(h);
+                h->isNeighborListValid = hi->isNeighborListValid = false;
+                h->neighborsChanged = hi->neighborsChanged = true;
+            }
+        }
+
+        // connect hosts in range from the surrounding cells
+        int col = std::max(0, std::min(numCols-1, (int)(hpos.x / cellSize)));
+        int row = std::max(0, std::min(numRows-1, (int)(hpos.y / cellSize)));
+        for (int r = std::max(0, row-1); r <= std::min(numRows-1, row+1); r++)
+        {
+            for (int c = std::max(0, col-1); c <= std::min(numCols-1, col+1); c++)
+            {
+                HostRefVector& cell = grid[r * numCols + c];
+                for (unsigned int j = 0; j < cell.size(); j++)
+                {
+                    HostRef hi = cell[j];
+                    if (hi != h && hpos.sqrdist(hi->pos) < maxDistSquared && h->neighbors.insert(hi).second)
+                    {
+                        hi->neighbors.insert(h);
+                        h->isNeighborListValid = hi->isNeighborListValid = false;
+                        h->neighborsChanged = hi->neighborsChanged = true;
+                    }
+                }
+            }
+        }
+    }
+}
+
 void ChannelControl::checkChannel(const int channel)
 {
     if (channel >= numChannels || channel < 0)
@@ -222,7 +351,129 @@ void ChannelControl::updateHostPosition(HostRef h, const Coord& pos)
 {
     Enter_Method_Silent();
     h->pos = pos;
-    updateConnections(h);
+    if (!trajectoryBased)
+        updateConnections(h);
+    else
+        updateGridCell(h);
+}
+
+void ChannelControl::registerTrajectory(HostRef h, BasicMobility *mobility)
+{
+    Enter_Method_Silent();
+    h->trajectory = mobility;
+    h->speed = mobility->getSegmentSpeed();
+    gridMaxSpeed = std::max(gridMaxSpeed, h->speed);
+}
+
+void ChannelControl::evaluateTrajectory(HostRef h)
+{
+    h->pos = h->trajectory->getPositionAt(simTime());
+}
+
+void ChannelControl::buildTrajectoryGrid()
+{
+    // cells are at least maxInterferenceDistance wide, like in updateConnections(const HostRefVector&)
+    gridCellSize = std::max(maxInterferenceDistance,
+                            std::max(playgroundSize.x, playgroundSize.y) / MAX_GRID_DIMENSION);
+    gridCols = (int)(playgroundSize.x / gridCellSize) + 1;
+    gridRows = (int)(playgroundSize.y / gridCellSize) + 1;
+    grid.resize(gridCols * gridRows);
+    for (unsigned int i = 0; i < grid.size(); i++)
+        grid[i].clear();  // keeps the capacity for the next rebuild
+
+    gridTime = simTime();
+    gridMaxSpeed = 0;
+    for (HostList::iterator it = hosts.begin(); it != hosts.end(); ++it)
+    {
+        HostRef h = &(*it);
+        if (h->trajectory)
+            evaluateTrajectory(h);
+        h->gridCell = getGridCell(h->pos);
+        grid[h->gridCell].push_back(h);
+        gridMaxSpeed = std::max(gridMaxSpeed, h->speed);
+    }
+}
+
+void ChannelControl::updateGridCell(HostRef h)
+{
+    if (grid.empty())
+        return;  // built on the first getNeighbors() call
+
+    // h->pos is where the host is now (e.g. at a waypoint), so the slack
+    // computed from gridTime holds for it in the new cell too
+    int cell = getGridCell(h->pos);
+    if (cell == h->gridCell)
+        return;
+    if (h->gridCell != -1)
+    {
+        HostRefVector& oldCell = grid[h->gridCell];
+        oldCell.erase(std::find(oldCell.begin(), oldCell.end(), h));
+    }
+    h->gridCell = cell;
+    grid[cell].push_back(h);
+}
+
+void ChannelControl::registerMobility(HostRef h, BasicMobility *mobility)
+{
+    Enter_Method_Silent();
+    if (h->mobility)
+        error("registerMobility(): host %s already registered", h->host->getFullPath().c_str());
+    h->mobility = mobility;
+    movingHosts.push_back(h);
+
+    if (!mobilityTimer)
+        mobilityTimer = new cMessage("mobilityUpdate");
+    if (!mobilityTimer->isScheduled())
+        scheduleAt(simTime() + getMobilityUpdateInterval(), mobilityTimer);
+}
+
+void ChannelControl::handleMessage(cMessage *msg)
+{
+    if (msg != mobilityTimer)
+        error("unexpected message (%s)%s", msg->getClassName(), msg->getName());
+
+    moveHosts();
+
+    if (!movingHosts.empty())
+        scheduleAt(simTime() + getMobilityUpdateInterval(), mobilityTimer);
+}
+
+void ChannelControl::moveHosts()
+{
+    // let every mobility model advance its host, then update the
+    // connections of all moved hosts in one go
+    int n = movingHosts.size();
+    std::vector<bool> keepMoving(n);
+    for (int i = 0; i < n; i++)
+    {
+        HostRef h = movingHosts[i];
+        cContextSwitcher tmp(h->mobility);
+        keepMoving[i] = h->mobility->periodicMove();
+        h->pos = h->mobility->getPosition();
+        h->neighborsChanged = false;
+    }
+
+    if (!trajectoryBased)
+        updateConnections(movingHosts);
+    else
+        for (int i = 0; i < n; i++)
+            updateGridCell(movingHosts[i]);
+
+    // only hosts whose neighbor set changed get NF_HOSTPOSITION_UPDATED
+    int k = 0;
+    for (int i = 0; i < n; i++)
+    {
+        HostRef h = movingHosts[i];
+        {
+            cContextSwitcher tmp(h->mobility);
+            h->mobility->positionUpdated(h->neighborsChanged || trajectoryBased);
+        }
+        if (keepMoving[i])
+            movingHosts[k++] = h;
+        else
+            h->mobility = NULL;
+    }
+    movingHosts.resize(k);
 }
 
 void ChannelControl::updateHostChannel(HostRef h, const int channel)
@@ -303,7 +554,7 @@ void ChannelControl::sendToChannel(cSimpleModule *srcRadioMod, HostRef srcHost,
             coreEV << "sending message to host listening on the same channel\n";
             // account for propagation delay, based on distance in meters
             // Over 300m, dt=1us=10 bit times @ 10Mbps
-            simtime_t delay = srcHost->pos.distance(h->pos) / LIGHT_SPEED;
+            simtime_t delay = getHostPosition(srcHost).distance(getHostPosition(h)) / LIGHT_SPEED;
             srcRadioMod->sendDirect(airFrame->dup(), delay, airFrame->getDuration(), h->radioInGate);
         }
         else
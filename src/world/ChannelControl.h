@@ -21,6 +21,7 @@
 #include <list>
 #include <deque>
 #include <set>
+#include <algorithm>
 #include <omnetpp.h>
 #include "AirFrame_m.h"
 #include "Coord.h"
@@ -28,6 +29,8 @@
 #define LIGHT_SPEED 3.0E+8
 #define TRANSMISSION_PURGE_INTERVAL 1.0
 
+class BasicMobility;
+
 /**
  * @brief Monitors which hosts are "in range". Supports multiple channels.
  *
@@ -56,16 +59,42 @@ class INET_API ChannelControl : public cSimpleModule
         cModule *host;
         cGate *radioInGate;
         int channel;
-        Coord pos; // cached
+        Coord pos; // cached; with trajectory-based positions, evaluated on demand
         std::set<HostRef> neighbors;  // cached neighbour list
 
         // we cache neighbors set in an std::vector, because std::set iteration is slow;
         // std::vector is created and updated on demand
         bool isNeighborListValid;
         HostRefVector neighborList;
+
+        // with centralized mobility updates
+        BasicMobility *mobility;  // NULL if the host is not moved by us
+        bool neighborsChanged;    // during updateConnections(const HostRefVector&)
+
+        // with trajectory-based positions
+        BasicMobility *trajectory;  // computes pos; NULL if pos is set via updateHostPosition()
+        double speed;               // speed on the current trajectory segment (m/s); 0 without trajectory
+        int gridCell;               // index of the host's cell in grid; -1 if not in the grid
     };
     HostList hosts;
 
+    /** @brief hosts moved by centralized mobility updates, see registerMobility() */
+    HostRefVector movingHosts;
+
+    /** @brief timer of centralized mobility updates */
+    cMessage *mobilityTimer;
+
+    /** @brief grid of cells, used by updateConnections(const HostRefVector&); with trajectory-based positions, by getNeighbors() */
+    std::vector<HostRefVector> grid;
+
+    /** @brief with trajectory-based positions: grid geometry, and when grid was built */
+    double gridCellSize;
+    int gridCols, gridRows;
+    simtime_t gridTime;
+
+    /** @brief with trajectory-based positions: the highest speed of any host since gridTime */
+    double gridMaxSpeed;
+
     /** @brief keeps track of ongoing transmissions; this is needed when a host
      * switches to another channel (then it needs to know whether the target channel
      * is empty or busy)
@@ -91,9 +120,37 @@ class INET_API ChannelControl : public cSimpleModule
     /** @brief the number of controlled channels */
     int numChannels;
 
+    /** @brief if true, neighbor lists are computed on demand from exact positions */
+    bool trajectoryBased;
+
   protected:
     virtual void updateConnections(HostRef h);
 
+    /** @brief Bulk version of updateConnections(HostRef), sets neighborsChanged of the given hosts */
+    virtual void updateConnections(const HostRefVector& movedHosts);
+
+    /** @brief Sets h->pos from its trajectory, at the current simulation time */
+    virtual void evaluateTrajectory(HostRef h);
+
+    /** @brief With trajectory-based positions: sorts all hosts into grid by their current positions */
+    virtual void buildTrajectoryGrid();
+
+    /** @brief With trajectory-based positions: moves h into the grid cell of h->pos, if the grid is built */
+    virtual void updateGridCell(HostRef h);
+
+    /** @brief Returns the index of the grid cell that contains pos */
+    int getGridCell(const Coord& pos) const {
+        int col = std::max(0, std::min(gridCols-1, (int)(pos.x / gridCellSize)));
+        int row = std::max(0, std::min(gridRows-1, (int)(pos.y / gridCellSize)));
+        return row * gridCols + col;
+    }
+
+    /** @brief Performs centralized mobility updates */
+    virtual void handleMessage(cMessage *msg);
+
+    /** @brief Moves all hosts registered with registerMobility() by one update interval */
+    virtual void moveHosts();
+
     /** @brief Calculate interference distance*/
     virtual double calcInterfDist();
 
@@ -131,9 +188,39 @@ class INET_API ChannelControl : public cSimpleModule
     /** @brief Returns the "handle" of a previously registered host */
     virtual HostRef lookupHost(cModule *host);
 
+    /** @brief Returns the "handle" of the registered host that contains the given module (or is the module), or NULL */
+    virtual HostRef lookupHostContaining(cModule *mod);
+
     /** @brief To be called when the host moved; updates proximity info */
     virtual void updateHostPosition(HostRef h, const Coord& pos);
 
+    /**
+     * @brief Returns the interval of centralized mobility updates, or 0 if
+     * every mobility module updates the position of its host on its own
+     */
+    virtual double getMobilityUpdateInterval() {return par("mobilityUpdateInterval");}
+
+    /**
+     * @brief From now on, the host is moved by centralized mobility updates:
+     * BasicMobility::periodicMove() of the given module gets called at every
+     * update, until it returns false.
+     */
+    virtual void registerMobility(HostRef h, BasicMobility *mobility);
+
+    /**
+     * @brief Returns true if positions are trajectory-based: mobility models
+     * that support it only report their trajectory at waypoint changes (see
+     * registerTrajectory()), and positions and neighbor lists are computed
+     * when transmissions happen.
+     */
+    virtual bool isTrajectoryBased() {return par("trajectoryBasedPositions");}
+
+    /**
+     * @brief From now on, the position of the host is computed on demand
+     * with BasicMobility::getPositionAt() of the given module.
+     */
+    virtual void registerTrajectory(HostRef h, BasicMobility *mobility);
+
     /** @brief Called when host switches channel */
     virtual void updateHostChannel(HostRef h, const int channel);
 
@@ -144,7 +231,7 @@ class INET_API ChannelControl : public cSimpleModule
     virtual void addOngoingTransmission(HostRef h, AirFrame *frame);
 
     /** @brief Returns the host's position */
-    const Coord& getHostPosition(HostRef h)  {return h->pos;}
+    const Coord& getHostPosition(HostRef h)  {if (h->trajectory) evaluateTrajectory(h); return h->pos;}
 
     /** @brief Get the list of modules in range of the given host */
     const HostRefVector& getNeighbors(HostRef h);